@@ -21,82 +21,223 @@
  * v4.2
  *  Created by Todd Morton
  *  Modified to fix bug in BOIGetStrg() so a BS can be the first character pressed.
+ * v4.3
+ *  Number conversion moved to StrFmt.c. Added BIOPrintf(), 10/18/2026
+ * v4.4
+ *  Added BIOWriteBlock(), interrupt driven transmit queue, 10/18/2026
+ * v4.5
+ *  Receive queue too. BIOWrite() and BIORead() no longer wait. Overflow counters,
+ *  10/18/2026
+ * v4.6
+ *  Added BIOWriteDesc(), eDMA transmit of caller buffers, 10/18/2026
+ * v4.7
+ *  Rate divisors computed from the bus clock, BIOSetRate(). FIFOs enabled, 10/18/2026
+ * v4.8
+ *  Added BIOClkChange() to keep the rate when the bus clock changes, 10/18/2026
+ * v4.9
+ *  Added BIOTxIdle() for stop mode entry, 10/18/2026
+ * v4.10
+ *  BIOPrintf() queues its line with one BIOWriteBlock(), 10/18/2026
  *******************************************************************************************
 * Project master header file
 ********************************************************************/
 #include "MCUType.h"
 #include "BasicIO.h"
+#include "StrFmt.h"
 #include "math.h"
 
 /*******************************************************************************************
 * Private Resources
 *******************************************************************************************/
-static INT8C bioHtoA(INT8U hnib);   //Convert nibble to ascii
 static INT8U bioIsHex(INT8C c);
 static INT8U bioHtoB(INT8C c);
+
+/* Transmit and receive queues serviced by UART2_RX_TX_IRQHandler(). Each has one
+ * writer and one reader, the main loop on one side and the interrupt on the other,
+ * so neither index is shared for writing. One slot is kept empty to tell full from
+ * empty. A byte that does not fit is dropped and counted. */
+#define BIO_TX_BUF_SIZE     512U        // Power of two, a few lines of text
+#define BIO_TX_IDX_MASK     (BIO_TX_BUF_SIZE - 1U)
+#define BIO_RX_BUF_SIZE     64U         // Power of two
+#define BIO_RX_IDX_MASK     (BIO_RX_BUF_SIZE - 1U)
+#define BIO_IRQ_PRIORITY    3U
+static INT8U bioTxBuf[BIO_TX_BUF_SIZE];
+static volatile INT16U bioTxHead = 0;
+static volatile INT16U bioTxTail = 0;
+static INT8U bioRxBuf[BIO_RX_BUF_SIZE];
+static volatile INT16U bioRxHead = 0;
+static volatile INT16U bioRxTail = 0;
+static INT32U bioTxOverflows = 0;           // Bytes dropped by BIOWrite(), BIOPrintf()
+static volatile INT32U bioRxOverflows = 0;  // Bytes lost, queue full or UART overrun
+void UART2_RX_TX_IRQHandler(void);
+
+/* Descriptor transmit. Descriptors queued by BIOWriteDesc() are sent straight from the
+ * caller's buffer by DMA channel BIO_DMA_CH on the UART2 transmit request (TDMAS). The
+ * UART has one TDRE, so the byte queue and the descriptors take turns: a descriptor
+ * starts when the byte queue is empty, and after each descriptor the byte queue is
+ * emptied before the next one starts. Order is kept within each, not between them. */
+#define BIO_DMA_CH          3U
+#define BIO_DMA_SRC         7U          // DMAMUX UART2 transmit source
+#define BIO_DESC_NONE       ((BIO_DESC_T *)0)
+static BIO_DESC_T *volatile bioDescHead = BIO_DESC_NONE; // Queued, not started
+static BIO_DESC_T *volatile bioDescTail = BIO_DESC_NONE;
+static BIO_DESC_T *volatile bioDescCur = BIO_DESC_NONE; // Being sent by the DMA
+static void bioDescStart(void);
+void DMA3_DMA19_IRQHandler(void);
+
+/* Rate generator and FIFOs. rate = bus/(16*(SBR + BRFA/32)), so the divisor is found in
+ * 1/32 steps as 2*bus/rate, rounded. The FIFO depth is read from PFIFO since it differs
+ * between the UARTs (UART2 may have only one entry). The watermarks are half of it. A
+ * receive watermark above one leaves the last bytes of a burst below it, so the idle
+ * line interrupt collects them. */
+#define BIO_SBR_MAX         0x1FFFU
+#define BIO_ERR_SCALE       10000       // BIOGetRateError() units, 0.01%
+static INT32U bioRate = 0;              // Actual rate
+static INT32U bioRateReq = BIO_BIT_RATE_9600;   // Rate asked for, kept for BIOClkChange()
+static INT16S bioRateErr = 0;
+static INT8U bioTxFifoDepth = 1U;
+static INT32U bioBusClk(void);
+static INT8U bioFifoDepth(INT8U code);
 /*******************************************************************************************
- * void BIOOpen(INT8U rate) - Initializes UART to operate at a specified rate.
+ * void BIOOpen(INT32U rate) - Initializes UART to operate at a specified rate.
  * MCU: K65, UART2 configured for debugger USB.
- * Acceptable rates:
- *  BIO_BIT_RATE_9600
- *  BIO_BIT_RATE_19200
- *  BIO_BIT_RATE_38400
- *  BIO_BIT_RATE_57600
- *  BIO_BIT_RATE_115200
+ * rate: bits per second, BIO_BIT_RATE_9600 up to BIO_BIT_RATE_MAX for the bus clock.
+ *       See BIOSetRate().
  ******************************************************************************************/
-void BIOOpen(INT8U rate){
+void BIOOpen(INT32U rate){
 
     SIM->SCGC5 |= SIM_SCGC5_PORTE(1); /* Enable clock gate for PORTE */
-    SIM->SCGC4 |= SIM_SCGC4_UART2(1); //enables UART2 clock (60MHz)
+    SIM->SCGC4 |= SIM_SCGC4_UART2(1); //enables UART2 clock (bus clock)
     PORTE->PCR[16]=PORT_PCR_MUX(3);    //ties peripherals to mux address
     PORTE->PCR[17]=PORT_PCR_MUX(3);
 
-    switch(rate){
-    case(BIO_BIT_RATE_9600):
-        UART2->BDH = 0x01U;
-        UART2->BDL = 0x86U;
-        UART2->C4 = 0x14U;
-        break;
-    case(BIO_BIT_RATE_19200):
-        UART2->BDH = 0x00U;
-        UART2->BDL = 0xC3U;
-        UART2->C4 = 0x0AU;
-        break;
-    case(BIO_BIT_RATE_38400):
-        UART2->BDH = 0x00U;
-        UART2->BDL = 0x61U;
-        UART2->C4 = 0x15U;
-        break;
-    case(BIO_BIT_RATE_57600):
-        UART2->BDH = 0x00U;
-        UART2->BDL = 0x41U;
-        UART2->C4 = 0x04U;
-        break;
-    case(BIO_BIT_RATE_115200):
-        UART2->BDH = 0x00U;
-        UART2->BDL = 0x20U;
-        UART2->C4 = 0x12U;
-        break;
-    default:    //Default to 9600bps
-        UART2->BDH = 0x01U;
-        UART2->BDL = 0x86U;
-        UART2->C4 = 0x14U;
-        break;
-    }
+    UART2->C2 = 0;
+    (void)BIOSetRate(rate);
+    bioTxFifoDepth = bioFifoDepth((INT8U)((UART2->PFIFO & UART_PFIFO_TXFIFOSIZE_MASK)>>
+                                          UART_PFIFO_TXFIFOSIZE_SHIFT));
+    UART2->TWFIFO = UART_TWFIFO_TXWATER(bioTxFifoDepth/2U);
+    UART2->RWFIFO = UART_RWFIFO_RXWATER(
+        (bioFifoDepth((INT8U)((UART2->PFIFO & UART_PFIFO_RXFIFOSIZE_MASK)>>
+                              UART_PFIFO_RXFIFOSIZE_SHIFT)) + 1U)/2U);
+    UART2->PFIFO |= (UART_PFIFO_TXFE_MASK|UART_PFIFO_RXFE_MASK);
+    UART2->CFIFO = (UART_CFIFO_TXFLUSH_MASK|UART_CFIFO_RXFLUSH_MASK);
     UART2->C2 |= UART_C2_TE_MASK;    //enables transmission
     UART2->C2 |= UART_C2_RE_MASK;    //enables receive
+    UART2->C2 |= UART_C2_RIE_MASK;   //RDRF interrupt fills the receive queue
+    UART2->C2 |= UART_C2_ILIE_MASK;  //Idle line collects bytes under the watermark
+    NVIC_SetPriority(UART2_RX_TX_IRQn, BIO_IRQ_PRIORITY);
+    NVIC_EnableIRQ(UART2_RX_TX_IRQn);
+
+    bioDescHead = BIO_DESC_NONE;
+    bioDescTail = BIO_DESC_NONE;
+    bioDescCur = BIO_DESC_NONE;
+    SIM->SCGC6 |= SIM_SCGC6_DMAMUX(1);
+    SIM->SCGC7 |= SIM_SCGC7_DMA(1);
+    DMAMUX->CHCFG[BIO_DMA_CH] = (DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_SOURCE(BIO_DMA_SRC));
+    NVIC_SetPriority(DMA3_DMA19_IRQn, BIO_IRQ_PRIORITY);
+    NVIC_EnableIRQ(DMA3_DMA19_IRQn);
+
+}
+
+/*******************************************************************************************
+* BIOSetRate() - Sets the bit rate from the current bus clock. Waits for the byte being
+*                shifted out, if any, so it is not cut.
+*    MCU: K65, UART2
+*    parameter: rate in bits per second. Rates above bus/16 are set to bus/16.
+*    return: the actual rate. BIOGetRateError() gives the error.
+*******************************************************************************************/
+INT32U BIOSetRate(INT32U rate){
+    INT32U bus;
+    INT32U div;
+    INT8U c2;
+    bus = bioBusClk();
+    if(rate == 0){
+        rate = BIO_BIT_RATE_9600;
+    }else{
+    }
+    bioRateReq = rate;
+    div = (INT32U)((((INT64U)bus*2U) + (rate/2U))/rate);    //SBR:BRFA, 1/32 steps
+    if(div < 32U){
+        div = 32U;
+    }else if(div > ((BIO_SBR_MAX<<5) | 0x1FU)){
+        div = (BIO_SBR_MAX<<5) | 0x1FU;
+    }else{
+    }
+    c2 = UART2->C2;
+    if((c2 & UART_C2_TE_MASK) != 0){
+        while((UART2->S1 & UART_S1_TC_MASK) == 0){}
+    }else{
+    }
+    UART2->C2 = c2 & (INT8U)~(UART_C2_TE_MASK|UART_C2_RE_MASK);
+    UART2->BDH = (INT8U)((UART2->BDH & (INT8U)~UART_BDH_SBR_MASK)|UART_BDH_SBR(div>>13));
+    UART2->BDL = UART_BDL_SBR(div>>5);                      //BDL write takes SBR
+    UART2->C4 = (INT8U)((UART2->C4 & (INT8U)~UART_C4_BRFA_MASK)|UART_C4_BRFA(div));
+    UART2->C2 = c2;
+    bioRate = (INT32U)((((INT64U)bus*2U) + (div/2U))/div);
+    bioRateErr = (INT16S)((((INT64S)bioRate - (INT64S)rate)*BIO_ERR_SCALE)/(INT64S)rate);
+    return bioRate;
+}
+
+/*******************************************************************************************
+* BIOClkChange() - Clock change callback, see K65TWR_ClkRegister(). Sets the last rate
+*                  asked for again from the new bus clock.
+*******************************************************************************************/
+void BIOClkChange(INT32U core_hz, INT32U bus_hz){
+    (void)BIOSetRate(bioRateReq);
+}
+
+/*******************************************************************************************
+* BIOGetRate() - Returns the actual bit rate set
+*******************************************************************************************/
+INT32U BIOGetRate(void){
+    return bioRate;
+}
+
+/*******************************************************************************************
+* BIOGetRateError() - Returns the error of the actual rate from the rate asked for, in
+*                     0.01% units. Signed, positive when fast.
+*******************************************************************************************/
+INT16S BIOGetRateError(void){
+    return bioRateErr;
+}
+
+/*******************************************************************************************
+* bioBusClk() - Bus clock in Hz, from the core clock and the SIM dividers. Both come
+*               from the same MCGOUTCLK.
+*******************************************************************************************/
+static INT32U bioBusClk(void){
+    INT32U outdiv1;
+    INT32U outdiv2;
+    SystemCoreClockUpdate();
+    outdiv1 = ((SIM->CLKDIV1 & SIM_CLKDIV1_OUTDIV1_MASK)>>SIM_CLKDIV1_OUTDIV1_SHIFT) + 1U;
+    outdiv2 = ((SIM->CLKDIV1 & SIM_CLKDIV1_OUTDIV2_MASK)>>SIM_CLKDIV1_OUTDIV2_SHIFT) + 1U;
+    return (SystemCoreClock*outdiv1)/outdiv2;
+}
 
+/*******************************************************************************************
+* bioFifoDepth() - Entries for a PFIFO TXFIFOSIZE/RXFIFOSIZE code
+*******************************************************************************************/
+static INT8U bioFifoDepth(INT8U code){
+    INT8U depth;
+    if(code == 0){
+        depth = 1U;
+    }else{
+        depth = (INT8U)(1U<<(code + 1U));
+    }
+    return depth;
 }
 
 /*******************************************************************************************
-* BIORead() - Checks for a character received
+* BIORead() - Takes the oldest character from the receive queue. Never blocks.
 *    MCU: K65, UART2
 *    return: ASCII character received or 0 if no character received
 *******************************************************************************************/
 INT8C BIORead(void){
     INT8C c;
-    if ((UART2->S1 & UART_S1_RDRF_MASK) != 0){   //check if char received
-        c = UART2->D;
+    INT16U tail = bioRxTail;
+    if (tail != bioRxHead){                 //check if char received
+        c = (INT8C)bioRxBuf[tail];
+        bioRxTail = (tail + 1U) & BIO_RX_IDX_MASK;
     }else{
         c = '\0';                           //If not return 0
     }
@@ -115,14 +256,201 @@ INT8C BIOGetChar(void){
 }
 
 /*******************************************************************************************
-* BIOWrite() - Sends an ASCII character
-*              Blocks as much as one character time
+* BIOWrite() - Queues an ASCII character to be sent. Never blocks. If the
+*              transmit queue is full the character is dropped and counted.
 *    MCU: K65, UART2
 *    parameter: c is the ASCII character to be sent
+*    return: TRUE if queued, FALSE if dropped
 *******************************************************************************************/
-void BIOWrite(INT8C c){
-    while ((UART2->S1 & UART_S1_TDRE_MASK)==0){} //waits until transmission
-    UART2->D = (INT8U)c;                             //is ready
+INT8U BIOWrite(INT8C c){
+    INT8U queued;
+    queued = BIOWriteBlock((const INT8U *)&c, 1U);
+    if(queued == FALSE){
+        bioTxOverflows++;
+    }else{
+    }
+    return queued;
+}
+
+/*******************************************************************************************
+* BIOWriteBlock() - Queues a block of bytes to be sent by the UART interrupt.
+*                   Never blocks. The block is queued whole or not at all, so
+*                   framed data is never cut.
+*    MCU: K65, UART2
+*    parameters: buf is the data, len is the number of bytes
+*    return: TRUE if queued, FALSE if there was not room for all of it
+*******************************************************************************************/
+INT8U BIOWriteBlock(const INT8U *const buf, INT16U len){
+    INT8U queued;
+    INT16U head;
+    INT16U i;
+    head = bioTxHead;
+    if(len > ((bioTxTail - head - 1U) & BIO_TX_IDX_MASK)){
+        queued = FALSE;
+    }else{
+        for(i = 0; i < len; i++){
+            bioTxBuf[head] = buf[i];
+            head = (head + 1U) & BIO_TX_IDX_MASK;
+        }
+        bioTxHead = head;
+        UART2->C2 |= UART_C2_TIE_MASK;      //TDRE interrupt sends it
+        queued = TRUE;
+    }
+    return queued;
+}
+
+/*******************************************************************************************
+* UART2_RX_TX_IRQHandler() - Moves received bytes from the FIFO to the queue and
+*                            refills the transmit FIFO each time TDRE is set. The
+*                            TDRE interrupt is turned off when the queue is empty.
+*******************************************************************************************/
+void UART2_RX_TX_IRQHandler(void){
+    INT8U status;
+    INT8U data;
+    INT16U head;
+    INT16U next;
+    INT16U tail;
+    status = UART2->S1;
+    if((status & (UART_S1_RDRF_MASK|UART_S1_OR_MASK|UART_S1_IDLE_MASK)) != 0){
+        if((status & UART_S1_OR_MASK) != 0){
+            bioRxOverflows++;
+        }else{
+        }
+        if(UART2->RCFIFO == 0){             //Idle with nothing left, D read clears it
+            (void)UART2->D;
+            UART2->CFIFO |= UART_CFIFO_RXFLUSH_MASK;
+            UART2->SFIFO = UART_SFIFO_RXUF_MASK;
+        }else{
+        }
+        while(UART2->RCFIFO != 0){          //S1 read then D reads clear RDRF, OR and IDLE
+            data = UART2->D;
+            head = bioRxHead;
+            next = (head + 1U) & BIO_RX_IDX_MASK;
+            if(next != bioRxTail){
+                bioRxBuf[head] = data;
+                bioRxHead = next;
+            }else{
+                bioRxOverflows++;
+            }
+        }
+    }else{
+    }
+    tail = bioTxTail;
+    if(bioDescCur != BIO_DESC_NONE){        //TDRE belongs to the DMA
+    }else if(tail != bioTxHead){
+        if((status & UART_S1_TDRE_MASK) != 0){      //S1 read then D write clears TDRE
+            while((tail != bioTxHead) && (UART2->TCFIFO < bioTxFifoDepth)){
+                UART2->D = bioTxBuf[tail];
+                tail = (tail + 1U) & BIO_TX_IDX_MASK;
+            }
+            bioTxTail = tail;
+        }else{
+        }
+    }else if(bioDescHead != BIO_DESC_NONE){
+        bioDescStart();
+    }else{
+        UART2->C2 &= (INT8U)~UART_C2_TIE_MASK;
+    }
+}
+
+/*******************************************************************************************
+* BIOWriteDesc() - Queues a caller owned buffer to be sent by DMA. Never blocks and
+*                  nothing is copied. The buffer and the descriptor belong to BasicIO
+*                  until desc->done is called, from the DMA interrupt, with desc.
+*    MCU: K65, UART2, DMA channel 3
+*    parameter: desc - buf, len (1 to BIO_DESC_MAX_LEN) and done (may be 0) set
+*    return: TRUE if queued, FALSE if len is out of range
+*******************************************************************************************/
+INT8U BIOWriteDesc(BIO_DESC_T *const desc){
+    INT8U queued;
+    if((desc->len == 0) || (desc->len > BIO_DESC_MAX_LEN)){
+        queued = FALSE;
+    }else{
+        desc->next = BIO_DESC_NONE;
+        NVIC_DisableIRQ(UART2_RX_TX_IRQn);
+        NVIC_DisableIRQ(DMA3_DMA19_IRQn);
+        if(bioDescHead == BIO_DESC_NONE){
+            bioDescHead = desc;
+        }else{
+            bioDescTail->next = desc;
+        }
+        bioDescTail = desc;
+        UART2->C2 |= UART_C2_TIE_MASK;      //Started when the byte queue is empty
+        NVIC_EnableIRQ(DMA3_DMA19_IRQn);
+        NVIC_EnableIRQ(UART2_RX_TX_IRQn);
+        queued = TRUE;
+    }
+    return queued;
+}
+
+/*******************************************************************************************
+* bioDescStart() - Starts the DMA on the next queued descriptor and hands TDRE to it.
+*                  Called from the interrupts only, with TIE set.
+*******************************************************************************************/
+static void bioDescStart(void){
+    BIO_DESC_T *desc = bioDescHead;
+    bioDescHead = desc->next;
+    bioDescCur = desc;
+    DMA0->TCD[BIO_DMA_CH].SADDR = DMA_SADDR_SADDR((INT32U)desc->buf);
+    DMA0->TCD[BIO_DMA_CH].SOFF = DMA_SOFF_SOFF(1U);
+    DMA0->TCD[BIO_DMA_CH].ATTR = (DMA_ATTR_SSIZE(0U)|DMA_ATTR_DSIZE(0U));
+    DMA0->TCD[BIO_DMA_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(1U);
+    DMA0->TCD[BIO_DMA_CH].SLAST = DMA_SLAST_SLAST(0U);
+    DMA0->TCD[BIO_DMA_CH].DADDR = DMA_DADDR_DADDR((INT32U)&UART2->D);
+    DMA0->TCD[BIO_DMA_CH].DOFF = DMA_DOFF_DOFF(0U);
+    DMA0->TCD[BIO_DMA_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(desc->len);
+    DMA0->TCD[BIO_DMA_CH].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(desc->len);
+    DMA0->TCD[BIO_DMA_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0U);
+    DMA0->TCD[BIO_DMA_CH].CSR = (DMA_CSR_DREQ(1)|DMA_CSR_INTMAJOR(1));
+    DMA0->SERQ = DMA_SERQ_SERQ(BIO_DMA_CH);
+    UART2->C5 |= UART_C5_TDMAS_MASK;        //TDRE now requests the DMA
+}
+
+/*******************************************************************************************
+* DMA3_DMA19_IRQHandler() - Descriptor sent. Gives TDRE back to the byte queue, releases
+*                           the descriptor, then starts the next one if the byte queue
+*                           is empty. Otherwise UART2_RX_TX_IRQHandler() starts it.
+*******************************************************************************************/
+void DMA3_DMA19_IRQHandler(void){
+    BIO_DESC_T *desc = bioDescCur;
+    DMA0->CINT = DMA_CINT_CINT(BIO_DMA_CH);
+    UART2->C5 &= (INT8U)~UART_C5_TDMAS_MASK;
+    bioDescCur = BIO_DESC_NONE;
+    if(desc->done != 0){
+        desc->done(desc);
+    }else{
+    }
+    if(bioTxTail != bioTxHead){
+    }else if(bioDescHead != BIO_DESC_NONE){
+        bioDescStart();
+    }else{
+        UART2->C2 &= (INT8U)~UART_C2_TIE_MASK;
+    }
+}
+
+/*******************************************************************************************
+* BIOGetOverflows() - Returns the bytes dropped since BIOOpen()
+*    parameters: tx gets the count of characters BIOWrite() could not queue,
+*                rx the count of received bytes lost to a full queue or overrun.
+*                BIOWriteBlock() refusals are not counted, the caller keeps them.
+*******************************************************************************************/
+void BIOGetOverflows(INT32U *const tx, INT32U *const rx){
+    *tx = bioTxOverflows;
+    *rx = bioRxOverflows;
+}
+
+/*******************************************************************************************
+* BIOTxIdle() - Returns TRUE when nothing is queued or being sent and the last stop bit
+*               is out, so the UART clock can be stopped without cutting a frame.
+*******************************************************************************************/
+INT8U BIOTxIdle(void){
+    INT8U idle = FALSE;
+    if((bioTxTail == bioTxHead) && (bioDescCur == BIO_DESC_NONE) &&
+       (bioDescHead == BIO_DESC_NONE) && ((UART2->S1 & UART_S1_TC_MASK) != 0)){
+        idle = TRUE;
+    }else{
+    }
+    return idle;
 }
 
 /*******************************************************************************************
@@ -137,6 +465,26 @@ void BIOPutStrg(const INT8C *const strg){
     }
 }
 
+/*******************************************************************************************
+* BIOPrintf() - Formats into a local buffer with FmtVSPrintf() then queues it in one
+*               BIOWriteBlock(). If the transmit queue has no room for the whole line
+*               it is dropped and its bytes counted like BIOWrite() drops.
+*    parameter: fmt is the format string followed by its arguments.
+*******************************************************************************************/
+void BIOPrintf(const INT8C *fmt, ...){
+    INT8C strg[BIO_PRINTF_SIZE];
+    INT8U len;
+    va_list args;
+
+    va_start(args, fmt);
+    len = FmtVSPrintf(strg, (INT8U)BIO_PRINTF_SIZE, fmt, args);
+    va_end(args);
+    if(BIOWriteBlock((const INT8U *)strg, len) == FALSE){
+        bioTxOverflows += len;
+    }else{
+    }
+}
+
 /*******************************************************************************************
 * BIOOutDecWord() - Outputs a decimal value of a 32-bit word.
 *    Parameters: binword is the word to be sent,
@@ -155,72 +503,9 @@ void BIOPutStrg(const INT8C *const strg){
 
 *******************************************************************************************/
 void BIOOutDecWord (INT32U binword, INT8U field, BIO_OUTDEC_MODE mode){
-    INT8C digitstrg[11];
-    INT32U lbinword = binword;
-    INT8U num_digits = field;
-    INT8U digit_index;
-    INT8U val_index;
-
-    //Clamp field size to acceptable values
-    if(num_digits > 10){
-        num_digits = 10;
-    }else if(num_digits < 1){
-        num_digits = 1;
-    }else{
-    }
-   //Calculate the digits needed for lbinword
-    digit_index = num_digits + 1;
-    digit_index--;
-    digitstrg[digit_index] = '\0';   //always ends in null
-    while((digit_index > 0) && (lbinword > 0)){
-        digit_index--;
-        digitstrg[digit_index] = (INT8C)((lbinword % 10) +'0');
-        lbinword = lbinword/10;
-    }
-
-    if(digit_index == num_digits){       //always at least a '0'
-        digit_index--;
-        digitstrg[digit_index] = '0';
-    }else{
-    }
-    if(lbinword > 0){  //Writes '-' to all field slots if bin length exceeded field
-        digit_index = 0;
-        while(digit_index < num_digits){
-            digitstrg[digit_index] = '-';
-            digit_index++;
-        }
-        digitstrg[digit_index] = '\0';
-        BIOPutStrg(digitstrg);
-    }else{
-        if((mode == BIO_OD_MODE_AR) || (mode == BIO_OD_MODE_LZ)){   //align right so fill rest with spaces to clear
-            while(digit_index > 0){
-                digit_index--;
-                if(mode == BIO_OD_MODE_AR){
-                    digitstrg[digit_index] = ' ';
-                }else if(mode == BIO_OD_MODE_LZ){
-                    digitstrg[digit_index] = '0';
-                }else{
-                }
-            }
-            BIOPutStrg(digitstrg);
-
-        }else if(mode == BIO_OD_MODE_AL){
-            val_index = digit_index;
-            digit_index = 0;
-            while(val_index < (num_digits)){
-                digitstrg[digit_index] = digitstrg[val_index];
-                val_index++;
-                digit_index++;
-            }
-            while(digit_index < num_digits){
-                digitstrg[digit_index] = ' ';
-                digit_index++;
-            }
-            digitstrg[(digit_index)] = '\0';
-            BIOPutStrg(digitstrg);
-        }else{
-        }
-    }
+    INT8C digitstrg[FMT_DEC_MAX_DIGITS + 1U];
+    (void)FmtDecWord(digitstrg, binword, field, (FMT_DEC_MODE)mode);  //Same mode order
+    BIOPutStrg(digitstrg);
 }
 
 /*******************************************************************************************
@@ -319,8 +604,9 @@ INT8U BIOHexStrgtoWord(INT8C *const strg,INT32U *bin){
 * bin is the byte to be sent
 *******************************************************************************************/
 void BIOOutHexByte(INT8U bin){
-    BIOWrite(bioHtoA(bin>>4));
-    BIOWrite(bioHtoA(bin & 0x0fu));
+    INT8C hexstrg[3];
+    (void)FmtHexWord(hexstrg, bin, 2);
+    BIOPutStrg(hexstrg);
 }
 
 /*******************************************************************************************
@@ -328,8 +614,9 @@ void BIOOutHexByte(INT8U bin){
 * bin is the word to be sent
 *******************************************************************************************/
 void BIOOutHexHWord(INT16U bin){
-    BIOOutHexByte((INT8U)(bin>>8));
-    BIOOutHexByte((INT8U)(bin & 0x00ffu));
+    INT8C hexstrg[5];
+    (void)FmtHexWord(hexstrg, bin, 4);
+    BIOPutStrg(hexstrg);
 }
 /*******************************************************************************************
 * BIOOutHexWord() - Output 32-bit word in hex.
@@ -337,10 +624,9 @@ void BIOOutHexHWord(INT16U bin){
 * Todd Morton, 10/14/2014
 *******************************************************************************************/
 void BIOOutHexWord(INT32U bin){
-    BIOOutHexByte((INT8U)(bin>>24));
-    BIOOutHexByte((INT8U)(bin>>16));
-    BIOOutHexByte((INT8U)(bin>>8));
-    BIOOutHexByte((INT8U)(bin & 0x000000ff));
+    INT8C hexstrg[9];
+    (void)FmtHexWord(hexstrg, bin, 8);
+    BIOPutStrg(hexstrg);
 }
 /*******************************************************************************************
 * bioIsHex() - Checks for hex ascii character - private
@@ -377,18 +663,3 @@ static INT8U bioHtoB(INT8C c){
     }
     return bin;
 }
-/*******************************************************************************************
-* bioHtoA() - Converts a hex nibble to ASCII - private
-* hnib is the byte with the LSN to be sent
-* Todd Morton, 10/14/2014
-*******************************************************************************************/
-static INT8C bioHtoA(INT8U hnib){
-    INT8C asciic;
-    INT8U hnmask = hnib & 0x0fu; /* Take care of any upper nibbles */
-    if(hnmask <= 9U){
-        asciic = (INT8C)(hnmask + 0x30U);
-    }else{
-        asciic = (INT8C)(hnmask + 0x37U);
-    }
-    return asciic;
-}
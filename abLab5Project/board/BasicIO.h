@@ -21,23 +21,56 @@
  * v4.2
  *  Created by Todd Morton
  *  Modified to fix bug in BOIGetStrg() so a BS can be the first character pressed.
+* v4.3
+*  Number conversion moved to StrFmt.c. Added BIOPrintf(), 10/18/2026
+* v4.4
+*  Added BIOWriteBlock(), interrupt driven transmit queue, 10/18/2026
+* v4.5
+*  Receive queue too. BIOWrite() and BIORead() no longer wait. Overflow counters,
+*  10/18/2026
+* v4.6
+*  Added BIOWriteDesc(), eDMA transmit of caller buffers, 10/18/2026
+* v4.7
+*  Rate divisors computed from the bus clock, BIOSetRate(). FIFOs enabled, 10/18/2026
+* v4.8
+*  Added BIOClkChange() to keep the rate when the bus clock changes, 10/18/2026
+* v4.9
+*  Added BIOTxIdle() for stop mode entry, 10/18/2026
+* v4.10
+*  BIOPrintf() queues its line with one BIOWriteBlock(), 10/18/2026
 ********************************************************************/
 #ifndef BIO_INCL
 #define BIO_INCL
+#include "StrFmt.h"
 
 /******************************************************************************************
- * Defined UART bit rates
+ * Defined UART bit rates, bits per second. Any rate up to bus/16 can be used.
  ******************************************************************************************/
-#define BIO_BIT_RATE_9600   0
-#define BIO_BIT_RATE_19200  1
-#define BIO_BIT_RATE_38400  2
-#define BIO_BIT_RATE_57600  3
-#define BIO_BIT_RATE_115200 4
+#define BIO_BIT_RATE_9600   9600U
+#define BIO_BIT_RATE_19200  19200U
+#define BIO_BIT_RATE_38400  38400U
+#define BIO_BIT_RATE_57600  57600U
+#define BIO_BIT_RATE_115200 115200U
+#define BIO_BIT_RATE_1M     1000000U
+#define BIO_BIT_RATE_3M     3000000U
+#define BIO_BIT_RATE_MAX    0xFFFFFFFFU     // bus/16, 3.75Mbps at 60MHz
 
 /*************************************************************************
 * Enumerated type for mode parameter in BIOOutDecWord()
 *************************************************************************/
 
+/*************************************************************************
+* Transmit descriptor for BIOWriteDesc(). The caller owns it and its buffer
+* again when done is called.
+*************************************************************************/
+#define BIO_DESC_MAX_LEN 32767U     // eDMA major loop count limit
+typedef struct bio_desc{
+    const INT8U *buf;
+    INT16U len;                                 // 1 - BIO_DESC_MAX_LEN
+    void (*done)(struct bio_desc *const desc);  // From the DMA interrupt, or 0
+    struct bio_desc *next;                      // Used by BasicIO
+}BIO_DESC_T;
+
 typedef enum {
     BIO_OD_MODE_LZ,
     BIO_OD_MODE_AR,
@@ -50,17 +83,33 @@ typedef enum {
 ********************************************************************/
 /********************************************************************
 * BIOOpen() - Initialization routine for BasicIO()
-* Acceptable rates:
-*  BIO_BIT_RATE_9600
-*  BIO_BIT_RATE_19200
-*  BIO_BIT_RATE_38400
-*  BIO_BIT_RATE_57600
-*  BIO_BIT_RATE_115200
+*    rate: bits per second, e.g. BIO_BIT_RATE_115200. See BIOSetRate().
+*    The UART FIFOs are enabled with half full watermarks.
+********************************************************************/
+void BIOOpen(INT32U rate);
+
+/********************************************************************
+* BIOSetRate() - Sets the bit rate from the current bus clock
+*    rate: bits per second, limited to bus/16
+*    return: the actual rate set
+********************************************************************/
+INT32U BIOSetRate(INT32U rate);
+
+/********************************************************************
+* BIOGetRate() - Actual bit rate set
+* BIOGetRateError() - Actual rate error in 0.01% units, + is fast
 ********************************************************************/
-void BIOOpen(INT8U rate);
+INT32U BIOGetRate(void);
+INT16S BIOGetRateError(void);
 
 /********************************************************************
-* BIORead() - Checks for a character received
+* BIOClkChange() - Clock change callback for K65TWR_ClkRegister().
+*                  Recomputes the rate divisors for the new bus clock.
+********************************************************************/
+void BIOClkChange(INT32U core_hz, INT32U bus_hz);
+
+/********************************************************************
+* BIORead() - Takes a character from the receive queue, never blocks
 *    return: ASCII character received or 0 if no character received
 ********************************************************************/
 INT8C BIORead(void);     /* Reads received character, 0 if none */
@@ -89,11 +138,42 @@ INT8C BIOGetChar(void);  /* Blocks until a character is received */
 INT8U BIOGetStrg(INT8U strglen,INT8C *const strg); /*input a string */
 
 /********************************************************************
-* BIOWrite() - Sends an ASCII character
-*              Blocks as much as one character time
+* BIOWrite() - Queues an ASCII character to be sent, never blocks.
+*              Dropped and counted if the transmit queue is full.
 *    parameter: c is the ASCII character to be sent
+*    return: TRUE if queued, FALSE if dropped
 ********************************************************************/
-void BIOWrite(INT8C c);  /* Send an ascii character */
+INT8U BIOWrite(INT8C c);  /* Send an ascii character */
+
+/********************************************************************
+* BIOWriteBlock() - Queues bytes to be sent by the UART interrupt.
+*                   Never blocks. All len bytes are queued or none.
+*    parameters: buf is the data, len is the number of bytes
+*    return: TRUE if queued, FALSE if the queue was too full
+********************************************************************/
+INT8U BIOWriteBlock(const INT8U *const buf, INT16U len);
+
+/********************************************************************
+* BIOWriteDesc() - Queues desc->buf to be sent by DMA with no copy.
+*                  Never blocks. desc->done(desc) is called from the
+*                  DMA interrupt when the last byte has been written.
+*    parameter: desc with buf, len and done set
+*    return: TRUE if queued, FALSE if len is out of range
+********************************************************************/
+INT8U BIOWriteDesc(BIO_DESC_T *const desc);
+
+/********************************************************************
+* BIOGetOverflows() - Bytes dropped since BIOOpen()
+*    parameters: tx - characters BIOWrite() could not queue
+*                rx - received bytes lost, queue full or UART overrun
+********************************************************************/
+void BIOGetOverflows(INT32U *const tx, INT32U *const rx);
+
+/********************************************************************
+* BIOTxIdle() - TRUE when the transmit queue, the descriptors and
+*               the UART shifter are all empty
+********************************************************************/
+INT8U BIOTxIdle(void);
 
 /********************************************************************
 * BIOPutStrg() - Sends a C string
@@ -101,6 +181,17 @@ void BIOWrite(INT8C c);  /* Send an ascii character */
 ********************************************************************/
 void BIOPutStrg(const INT8C *const strg);
 
+/********************************************************************
+* BIOPrintf() - Sends a printf style formatted string
+*    parameter: fmt is the format string followed by its arguments.
+*    Supports %d %u %x %X %c %s with width, '-' and '0'. Output is
+*    limited to BIO_PRINTF_SIZE-1 characters, queued as one block so
+*    the line goes out whole or is dropped. Arguments are checked
+*    against fmt at compile time.
+********************************************************************/
+#define BIO_PRINTF_SIZE 80U
+void BIOPrintf(const INT8C *fmt, ...) FMT_PRINTF_CHECK(1,2);
+
 /*******************************************************************************************
 * BIOOutDecWord() - Outputs a decimal value of a 32-bit word.
 *    Parameters: binword is the word to be sent,
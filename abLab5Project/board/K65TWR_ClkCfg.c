@@ -9,6 +9,9 @@
  * (PLL) that is part of the microcontroller device.
  *
  * 09/06/2018 Todd Morton
+ * 10/18/2026 Added run time clock modes with change callbacks, K65TWR_ClkSetMode()
+ * 10/18/2026 Added run time clock profiles, K65TWR_ClkSetProfile()
+ * 10/18/2026 K65TWR_BootClock() writes MCG_C9, the PLL clock monitor, after lock
  *
  ***************************************************************************************/
 
@@ -16,6 +19,67 @@
 #include "MCUType.h"
 #include "K65TWR_ClkCfg.h"
 
+/****************************************************************************************
+ * Clock profile private resources. Every profile change goes through FBE, the MCG on
+ * the 16MHz crystal with the FLL and PLL bypassed, where any divider set is within
+ * limits. HSRUN is left there before the dividers change and entered there before the
+ * target clock is selected, so no clock is ever above its limit. CLK_MODE_LOW with a
+ * PEE profile stops short at PBE so the PLL stays locked.
+ * The values are from the predefined setups in K65TWR_ClkCfg.h:
+ *   FEI    - setup 0, slow IRC x 640 FLL
+ *   PEE120 - setup 5, 16MHz/2 x 30 /2
+ *   PEE180 - setup 1, 16MHz/2 x 45 /2, HSRUN, PLL clock monitor on
+ *   BLPI   - setup 2, fast IRC, FLL off
+ ***************************************************************************************/
+typedef struct{
+    INT8U mcg_mode;         /* MCG_MODE_FEI, MCG_MODE_PEE or MCG_MODE_BLPI */
+    INT8U hsrun;
+    INT8U c5;               /* PLL only */
+    INT8U c6;
+    INT8U c9;               /* PLL clock monitor, written after lock */
+    INT32U clkdiv1;
+    INT32U core_hz;
+    INT32U bus_hz;
+    const INT8C *name;
+}CLK_PROFILE_T;
+static const CLK_PROFILE_T clkProfiles[CLK_NUM_PROFILES] = {
+    {MCG_MODE_FEI,  FALSE, 0x00U, 0x00U, 0x00U, 0x00110000U, 20971520U,  20971520U, "fei"},
+    {MCG_MODE_PEE,  FALSE, 0x01U, 0x4EU, 0x00U, 0x01140000U, 120000000U, 60000000U, "pee120"},
+    {MCG_MODE_PEE,  TRUE,  0x01U, 0x5DU, 0x20U, 0x02260000U, 180000000U, 60000000U, "pee180"},
+    {MCG_MODE_BLPI, FALSE, 0x00U, 0x00U, 0x00U, 0x00040000U, 4000000U,   4000000U,  "blpi"}
+};
+#if defined(CLOCK_SETUP) && (CLOCK_SETUP == 0)
+#define CLK_BOOT_PROFILE    CLK_PROFILE_FEI
+#elif defined(CLOCK_SETUP) && (CLOCK_SETUP == 1)
+#define CLK_BOOT_PROFILE    CLK_PROFILE_PEE180
+#elif defined(CLOCK_SETUP) && (CLOCK_SETUP == 2)
+#define CLK_BOOT_PROFILE    CLK_PROFILE_BLPI
+#elif defined(CLOCK_SETUP) && ((CLOCK_SETUP == 4) || (CLOCK_SETUP == 5))
+#define CLK_BOOT_PROFILE    CLK_PROFILE_PEE120
+#endif                                      /* Setup 3, BLPE, has no profile */
+#define CLK_LOW_CORE_HZ     CPU_XTAL_CLK_HZ
+#define CLK_LOW_BUS_HZ      CPU_XTAL_CLK_HZ
+#define CLK_LOW_CLKDIV1     0x00000000U     /* All /1, flash 16MHz */
+#define CLK_PMSTAT_RUN      0x01U
+#define CLK_PMSTAT_HSRUN    0x80U
+#define CLK_MCG_CLKS_PLL    0x00U
+#define CLK_MCG_CLKS_INT    0x01U
+#define CLK_MCG_CLKS_EXT    0x02U
+#define CLK_MCG_FRDIV_EXT   4U              /* 16MHz/512, FLL reference in range */
+static CLK_CHANGE_FN clkCallbacks[CLK_MAX_CALLBACKS];
+static INT8U clkNumCallbacks = 0;
+static CLK_MODE clkMode = CLK_MODE_FULL;
+#ifdef CLK_BOOT_PROFILE
+static CLK_PROFILE clkProfile = CLK_BOOT_PROFILE;
+#else
+static CLK_PROFILE clkProfile = CLK_PROFILE_PEE180;
+#endif
+static void clkSelect(INT8U clks);
+static void clkRunMode(INT8U hsrun);
+static void clkToFbe(void);
+static void clkFromFbe(const CLK_PROFILE_T *const prof);
+static void clkChanged(void);
+
 /****************************************************************************************
  * Configure and start the system clocks based on the settings in K65TWR_ClkCfg.h
  * Todd Morton, 09/06/2018
@@ -242,9 +306,233 @@ void K65TWR_BootClock(void){
     SIM->CLKDIV3 = ((SIM->CLKDIV3) & (INT32U)(~(SIM_CLKDIV3_PLLFLLFRAC_MASK | SIM_CLKDIV3_PLLFLLDIV_MASK))) | ((SYSTEM_SIM_CLKDIV3_VALUE) & (SIM_CLKDIV3_PLLFLLFRAC_MASK | SIM_CLKDIV3_PLLFLLDIV_MASK)); /* Selects the PLLFLL clock divider. */
 #endif
 
+    /* PLL clock monitor, only once the PLL is locked and selected, as in clkFromFbe() */
+#if (MCG_MODE == MCG_MODE_PEE)
+    MCG->C9 = SYSTEM_MCG_C9_VALUE;
+#endif
+
     /* PLL loss of lock interrupt request initialization */
     if (((SYSTEM_MCG_C6_VALUE) & MCG_C6_LOLIE0_MASK) != 0U) {
         NVIC_EnableIRQ(MCG_IRQn);          /* Enable PLL loss of lock interrupt request */
     }
 #endif
 }
+
+/****************************************************************************************
+ * K65TWR_ClkRegister() - Adds a function to be called after each clock mode change.
+ *    fn - called with the new core and bus clocks in Hz
+ *    Returns TRUE if added, FALSE if CLK_MAX_CALLBACKS are already registered.
+ ***************************************************************************************/
+INT8U K65TWR_ClkRegister(CLK_CHANGE_FN fn){
+    INT8U added;
+    if(clkNumCallbacks < CLK_MAX_CALLBACKS){
+        clkCallbacks[clkNumCallbacks] = fn;
+        clkNumCallbacks++;
+        added = TRUE;
+    }else{
+        added = FALSE;
+    }
+    return added;
+}
+
+/****************************************************************************************
+ * K65TWR_ClkSetMode() - Changes the clock mode, updates SystemCoreClock and calls the
+ *                       registered callbacks. Does nothing if already in mode.
+ *                       CLK_MODE_LOW only changes the clocks of a PEE profile, the
+ *                       others already run in RUN from a slow clock.
+ *                       Call from the main loop only, never from an interrupt.
+ *    mode - CLK_MODE_FULL or CLK_MODE_LOW
+ ***************************************************************************************/
+void K65TWR_ClkSetMode(CLK_MODE mode){
+#ifdef CLK_BOOT_PROFILE
+    const CLK_PROFILE_T *prof = &clkProfiles[clkProfile];
+    if(mode != clkMode){
+        clkMode = mode;
+        if(prof->mcg_mode == MCG_MODE_PEE){
+            if(mode == CLK_MODE_LOW){
+                clkSelect(CLK_MCG_CLKS_EXT);        /* 16MHz crystal, PLL kept locked */
+                SIM->CLKDIV1 = CLK_LOW_CLKDIV1;
+                clkRunMode(FALSE);
+            }else{
+                clkRunMode(prof->hsrun);
+                SIM->CLKDIV1 = prof->clkdiv1;
+                while((MCG->S & MCG_S_LOCK0_MASK) == 0x00U){}
+                clkSelect(CLK_MCG_CLKS_PLL);
+            }
+            clkChanged();
+        }else{
+        }
+    }else{
+    }
+#endif
+}
+
+/****************************************************************************************
+ * K65TWR_ClkSetProfile() - Switches to another clock profile in CLK_MODE_FULL, updates
+ *                          SystemCoreClock and calls the registered callbacks. Does
+ *                          nothing if already there. Main loop only.
+ *    profile - one of CLK_PROFILE
+ ***************************************************************************************/
+void K65TWR_ClkSetProfile(CLK_PROFILE profile){
+#ifdef CLK_BOOT_PROFILE
+    const CLK_PROFILE_T *prof;
+    if(profile == clkProfile){
+        K65TWR_ClkSetMode(CLK_MODE_FULL);
+    }else if(profile < CLK_NUM_PROFILES){
+        prof = &clkProfiles[profile];
+        clkToFbe();
+        clkRunMode(FALSE);
+        SIM->CLKDIV1 = prof->clkdiv1;
+        clkRunMode(prof->hsrun);
+        clkFromFbe(prof);
+        clkProfile = profile;
+        clkMode = CLK_MODE_FULL;
+        clkChanged();
+    }else{
+    }
+#endif
+}
+
+/****************************************************************************************
+ * K65TWR_ClkGetProfile() - Returns the profile used in CLK_MODE_FULL
+ ***************************************************************************************/
+CLK_PROFILE K65TWR_ClkGetProfile(void){
+    return clkProfile;
+}
+
+/****************************************************************************************
+ * K65TWR_ClkProfileName() - Returns a short lower case name for profile, "?" if none
+ ***************************************************************************************/
+const INT8C *K65TWR_ClkProfileName(CLK_PROFILE profile){
+    const INT8C *name = "?";
+    if(profile < CLK_NUM_PROFILES){
+        name = clkProfiles[profile].name;
+    }else{
+    }
+    return name;
+}
+
+/****************************************************************************************
+ * clkSelect() - Selects the MCG output, PLL (PEE) or external reference (PBE), and
+ *               waits for the switch.
+ ***************************************************************************************/
+static void clkSelect(INT8U clks){
+    MCG->C1 = (INT8U)((MCG->C1 & (INT8U)~MCG_C1_CLKS_MASK)|MCG_C1_CLKS(clks));
+    if(clks == CLK_MCG_CLKS_PLL){
+        while((MCG->S & MCG_S_CLKST_MASK) != MCG_S_CLKST(3U)){}
+    }else{
+        while((MCG->S & MCG_S_CLKST_MASK) != MCG_S_CLKST(2U)){}
+    }
+}
+
+/****************************************************************************************
+ * clkRunMode() - Enters HSRUN or RUN and waits for it. Only change with the clocks
+ *                within the RUN limits.
+ ***************************************************************************************/
+static void clkRunMode(INT8U hsrun){
+    if(hsrun == TRUE){
+        SMC->PMCTRL = (INT8U)((SMC->PMCTRL & (INT8U)~SMC_PMCTRL_RUNM_MASK)|
+                              SMC_PMCTRL_RUNM(3U));
+        while(SMC->PMSTAT != CLK_PMSTAT_HSRUN){}
+    }else{
+        SMC->PMCTRL = (INT8U)(SMC->PMCTRL & (INT8U)~SMC_PMCTRL_RUNM_MASK);
+        while(SMC->PMSTAT != CLK_PMSTAT_RUN){}
+    }
+}
+
+/****************************************************************************************
+ * clkToFbe() - From PEE, PBE, FEI, FBI or BLPI to FBE with the PLL off. FEI and BLPI
+ *              go through FBI/FEI with the external reference selected first, the
+ *              crystal is kept running by OSC_CR[ERCLKEN].
+ ***************************************************************************************/
+static void clkToFbe(void){
+    if((MCG->S & MCG_S_CLKST_MASK) == MCG_S_CLKST(3U)){
+        clkSelect(CLK_MCG_CLKS_EXT);                /* PEE -> PBE */
+    }else{
+    }
+    MCG->C2 &= (INT8U)~MCG_C2_LP_MASK;             /* BLPI -> FBI */
+    if((MCG->S & MCG_S_IREFST_MASK) != 0x00U){      /* FEI or FBI -> FBE */
+        while((MCG->S & MCG_S_OSCINIT0_MASK) == 0x00U){}
+        MCG->C1 = (INT8U)(MCG_C1_CLKS(CLK_MCG_CLKS_EXT)|MCG_C1_FRDIV(CLK_MCG_FRDIV_EXT)|
+                          MCG_C1_IRCLKEN_MASK);
+        while((MCG->S & MCG_S_IREFST_MASK) != 0x00U){}
+        while((MCG->S & MCG_S_CLKST_MASK) != MCG_S_CLKST(2U)){}
+    }else{
+    }
+    if((MCG->S & MCG_S_PLLST_MASK) != 0x00U){       /* PBE -> FBE */
+        MCG->C9 &= (INT8U)~MCG_C9_PLL_CME_MASK;    /* No loss of clock, set again by
+                                                       clkFromFbe() for a PEE profile */
+        MCG->C6 &= (INT8U)~MCG_C6_PLLS_MASK;
+        while((MCG->S & MCG_S_PLLST_MASK) != 0x00U){}
+    }else{
+    }
+}
+
+/****************************************************************************************
+ * clkFromFbe() - From FBE to the MCG mode of prof. The dividers and run mode must
+ *                already be set for it.
+ ***************************************************************************************/
+static void clkFromFbe(const CLK_PROFILE_T *const prof){
+    if(prof->mcg_mode == MCG_MODE_PEE){             /* FBE -> PBE -> PEE */
+        MCG->C5 = prof->c5;
+        MCG->C6 = prof->c6;
+        while((MCG->S & MCG_S_PLLST_MASK) == 0x00U){}
+        while((MCG->S & MCG_S_LOCK0_MASK) == 0x00U){}
+        MCG->C9 = (INT8U)((MCG->C9 & (INT8U)~MCG_C9_PLL_CME_MASK)|
+                          (prof->c9 & MCG_C9_PLL_CME_MASK));
+        clkSelect(CLK_MCG_CLKS_PLL);
+    }else if(prof->mcg_mode == MCG_MODE_BLPI){      /* FBE -> FBI -> BLPI */
+        MCG->C2 |= MCG_C2_IRCS_MASK;                /* Fast IRC, FCRDIV from boot */
+        while((MCG->S & MCG_S_IRCST_MASK) == 0x00U){}
+        MCG->C1 = (INT8U)(MCG_C1_CLKS(CLK_MCG_CLKS_INT)|MCG_C1_IREFS_MASK|
+                          MCG_C1_IRCLKEN_MASK);
+        while((MCG->S & MCG_S_IREFST_MASK) == 0x00U){}
+        while((MCG->S & MCG_S_CLKST_MASK) != MCG_S_CLKST(1U)){}
+        MCG->C2 |= MCG_C2_LP_MASK;
+    }else{                                          /* FBE -> FEI */
+        MCG->C1 = (INT8U)(MCG_C1_IREFS_MASK|MCG_C1_IRCLKEN_MASK);
+        while((MCG->S & MCG_S_IREFST_MASK) == 0x00U){}
+        while((MCG->S & MCG_S_CLKST_MASK) != MCG_S_CLKST(0U)){}
+    }
+}
+
+/****************************************************************************************
+ * clkChanged() - Updates SystemCoreClock and tells the registered modules
+ ***************************************************************************************/
+static void clkChanged(void){
+    INT8U i;
+    SystemCoreClockUpdate();
+    for(i = 0; i < clkNumCallbacks; i++){
+        clkCallbacks[i](K65TWR_ClkGetCoreHz(), K65TWR_ClkGetBusHz());
+    }
+}
+
+/****************************************************************************************
+ * K65TWR_ClkGetMode() - Returns the clock mode
+ ***************************************************************************************/
+CLK_MODE K65TWR_ClkGetMode(void){
+    return clkMode;
+}
+
+/****************************************************************************************
+ * K65TWR_ClkGetCoreHz(), K65TWR_ClkGetBusHz() - Clocks of the current mode in Hz
+ ***************************************************************************************/
+INT32U K65TWR_ClkGetCoreHz(void){
+    INT32U hz;
+    if((clkMode == CLK_MODE_LOW) && (clkProfiles[clkProfile].mcg_mode == MCG_MODE_PEE)){
+        hz = CLK_LOW_CORE_HZ;
+    }else{
+        hz = clkProfiles[clkProfile].core_hz;
+    }
+    return hz;
+}
+
+INT32U K65TWR_ClkGetBusHz(void){
+    INT32U hz;
+    if((clkMode == CLK_MODE_LOW) && (clkProfiles[clkProfile].mcg_mode == MCG_MODE_PEE)){
+        hz = CLK_LOW_BUS_HZ;
+    }else{
+        hz = clkProfiles[clkProfile].bus_hz;
+    }
+    return hz;
+}
@@ -9,6 +9,10 @@
  * (PLL) that is part of the microcontroller device.
  *
  * 09/06/2018 Todd Morton
+ * 10/18/2026 Added K65TWR_CORE_CLK_HZ
+ * 10/18/2026 Added run time clock modes with change callbacks, K65TWR_ClkSetMode(),
+ *            and K65TWR_BUS_CLK_HZ
+ * 10/18/2026 Added run time clock profiles, K65TWR_ClkSetProfile()
  *
  ***************************************************************************************/
 #ifndef K65TWR_CLKCFG_H_
@@ -299,10 +303,53 @@
   #define DEFAULT_SYSTEM_CLOCK         20971520u
 #endif
 
+/* Core and bus clocks of the selected setup, for modules that time in core or bus
+ * cycles. Setup 1 leaves DEFAULT_SYSTEM_CLOCK undefined. */
+#if defined(CLOCK_SETUP) && (CLOCK_SETUP == 1)
+  #define K65TWR_CORE_CLK_HZ           180000000U
+  #define K65TWR_BUS_CLK_HZ            60000000U
+#elif defined(CLOCK_SETUP) && ((CLOCK_SETUP == 4) || (CLOCK_SETUP == 5))
+  #define K65TWR_CORE_CLK_HZ           DEFAULT_SYSTEM_CLOCK
+  #define K65TWR_BUS_CLK_HZ            60000000U
+#else
+  #define K65TWR_CORE_CLK_HZ           DEFAULT_SYSTEM_CLOCK
+  #define K65TWR_BUS_CLK_HZ            DEFAULT_SYSTEM_CLOCK
+#endif
+
 
 /****************************************************************************************
  * Function to configure the system clock to high-speed, 180MHz
  ***************************************************************************************/
 void K65TWR_BootClock(void);
 
+/****************************************************************************************
+ * Run time clock profiles, any CLOCK_SETUP but 3. K65TWR_BootClock() leaves the profile
+ * of CLOCK_SETUP in CLK_MODE_FULL.
+ *   CLK_PROFILE_FEI    - RUN, FEI, core and bus 20.97MHz
+ *   CLK_PROFILE_PEE120 - RUN, PEE, core 120MHz, bus 60MHz
+ *   CLK_PROFILE_PEE180 - HSRUN, PEE, core 180MHz, bus 60MHz
+ *   CLK_PROFILE_BLPI   - RUN, BLPI, core and bus 4MHz
+ * Run time clock modes:
+ *   CLK_MODE_FULL - the profile
+ *   CLK_MODE_LOW  - for PEE profiles RUN, PBE from the crystal, core and bus 16MHz. The
+ *                   PLL stays locked so going back to full speed takes no lock time.
+ *                   The other profiles are left as they are.
+ * Each registered callback is called with the new core and bus clocks after a change,
+ * so modules can rescale their timers and divisors.
+ ***************************************************************************************/
+typedef enum {CLK_MODE_FULL, CLK_MODE_LOW} CLK_MODE;
+typedef enum {CLK_PROFILE_FEI, CLK_PROFILE_PEE120, CLK_PROFILE_PEE180, CLK_PROFILE_BLPI,
+              CLK_NUM_PROFILES} CLK_PROFILE;
+typedef void (*CLK_CHANGE_FN)(INT32U core_hz, INT32U bus_hz);
+#define CLK_MAX_CALLBACKS 8U
+
+INT8U K65TWR_ClkRegister(CLK_CHANGE_FN fn);
+void K65TWR_ClkSetMode(CLK_MODE mode);
+CLK_MODE K65TWR_ClkGetMode(void);
+void K65TWR_ClkSetProfile(CLK_PROFILE profile);
+CLK_PROFILE K65TWR_ClkGetProfile(void);
+const INT8C *K65TWR_ClkProfileName(CLK_PROFILE profile);
+INT32U K65TWR_ClkGetCoreHz(void);
+INT32U K65TWR_ClkGetBusHz(void);
+
 #endif  /* #if !defined(K65TWR_CLKCFG_H_) */
@@ -2,109 +2,401 @@
  * Todd Morton, 11/18/2014
  * Todd Morton, 11/19/2018 MCUXpresso version
  * Todd Morton, 11/17/2020 MCUX11.2 version
+ * Added TSIGetSensorLevel() for bar graph display, 10/18/2026
+ * Scans are run from the end-of-scan interrupt, nothing waits on the TSI, 10/18/2026
+ * Added hardware threshold monitor mode, 10/18/2026
+ * Added baseline tracking, noise based thresholds, hysteresis and debounce, 10/18/2026
+ * Electrode list given to TSIInit(), pipelined round robin over it, 10/18/2026
+ * Added eDMA sweep collection with averaging in TSITask(), 10/18/2026
+ * Added per scan telemetry records for threshold tuning, 10/18/2026
+ * Added TSIGetSensorData(), 10/18/2026
+ * Monitor keeps scanning in stop modes, added TSIPeekSensorFlags(), 10/18/2026
  */
 #include "MCUType.h"
 #include "K65TWR_GPIO.h"
 #include "K65TWR_TSI.h"
 
-typedef enum {PROC1START2, PROC2START1} TSI_TASK_STATE_T;
 typedef struct{
-    INT16U baseline;
-    INT16U offset;
-    INT16U threshold;
+    INT32U baseq;       // Baseline, TSI_FRAC_BITS fixed point
+    INT16U baseline;    // Integer part of baseq
+    INT16U offset;      // Typical touch offset, 100% for TSIGetSensorLevel()
+    INT16U noiseq;      // Mean absolute deviation, TSI_FRAC_BITS fixed point
+    INT16U threshold;   // Touch on level
+    INT16U release;     // Touch off level
+    INT16U count;       // Last scan count
+    INT8U deb;          // Scans in a row that disagree with the touch state
 }TOUCH_LEVEL_T;
 
 
 #define MAX_NUM_ELECTRODES 16U
 
-#define E1_TOUCH_OFFSET  0x0400U    // Touch offset from baseline
-#define E2_TOUCH_OFFSET  0x0400U    // Determined experimentally
+/* Baseline and thresholds. While a channel is not touched its baseline and noise follow
+ * the counts with first order IIR filters, y += (x - y)/2^n, so slow drift is tracked.
+ * The touch threshold is TSI_NOISE_MULT times the noise above the baseline, but never
+ * less than the touch offset. Release is at half the threshold. A change of state
+ * needs TSI_DEB_SCANS scans in a row. */
+#define TSI_FRAC_BITS    4U
+#define TSI_BASE_SHIFT   8U         // Baseline time constant, 256 scans
+#define TSI_NOISE_SHIFT  4U         // Noise time constant, 16 scans
+#define TSI_NOISE_MULT   8U
+#define TSI_DEB_SCANS    2U
 #define TSI0_ENABLE()    TSI0->GENCS |= TSI_GENCS_TSIEN_MASK
 #define TSI0_DISABLE()   TSI0->GENCS &= ~TSI_GENCS_TSIEN_MASK
+/* NVIC priority 0 (highest) to 15. Below PIT0 (0, alarm wave) and PIT1 (2, LCD), the
+ * same as UART2 and PORTC, above LLWU (4). A scan takes ms so it can wait. */
+#define TSI_IRQ_PRIORITY 3U
 
+//16 consecutive scans, Prescale divide by 32
+//16uA ext. charge current, 16uA Ref. charge current, .592V dV
+#define TSI_GENCS_CFG    ((TSI_GENCS_EXTCHRG(5))|(TSI_GENCS_REFCHRG(5))| \
+                          (TSI_GENCS_DVOLT(1))|(TSI_GENCS_PS(5))|(TSI_GENCS_NSCN(15)))
+
+/* Monitor mode. LPTMR0 is the TSI hardware trigger. It runs from the 1kHz LPO so it
+ * keeps triggering scans in low-power modes, and the TSI compares each count with the
+ * TSHD window itself. The end-of-scan interrupt (also an LLWU wake-up source) reads
+ * OUTRGF, so a touch is flagged only after TSI_DEB_SCANS out-of-range scans in a row,
+ * and a released channel keeps tracking its baseline. It then moves TSICH and TSHD to
+ * the next channel. LPTMR0 is owned by this module while monitoring. */
+#define TSI_MON_PERIOD_MS 10U       // Between scans, must be longer than one scan
+#define TSI_LPTMR_LPO     1U        // LPTMR clock select, 1kHz LPO
+static INT8U tsiMonList[MAX_NUM_ELECTRODES];
+static INT8U tsiMonNum;             // 0 when not monitoring
+static INT8U tsiMonIdx;             // tsiMonList[] index configured in TSI0->DATA
+static void tsiMonSetCh(INT8U channel);
+
+/* Electrode pin for each TSI0 channel */
+typedef struct{
+    PORT_Type *port;
+    INT32U scgc5;       // SIM clock gate for the port
+    INT8U pin;
+}TSI_PIN_T;
+static const TSI_PIN_T tsiPinTable[MAX_NUM_ELECTRODES] = {
+    {PORTB, SIM_SCGC5_PORTB_MASK, 0U},  {PORTA, SIM_SCGC5_PORTA_MASK, 0U},
+    {PORTA, SIM_SCGC5_PORTA_MASK, 1U},  {PORTA, SIM_SCGC5_PORTA_MASK, 2U},
+    {PORTA, SIM_SCGC5_PORTA_MASK, 3U},  {PORTA, SIM_SCGC5_PORTA_MASK, 4U},
+    {PORTB, SIM_SCGC5_PORTB_MASK, 1U},  {PORTB, SIM_SCGC5_PORTB_MASK, 2U},
+    {PORTB, SIM_SCGC5_PORTB_MASK, 3U},  {PORTB, SIM_SCGC5_PORTB_MASK, 16U},
+    {PORTB, SIM_SCGC5_PORTB_MASK, 17U}, {PORTB, SIM_SCGC5_PORTB_MASK, 18U},
+    {PORTB, SIM_SCGC5_PORTB_MASK, 19U}, {PORTC, SIM_SCGC5_PORTC_MASK, 0U},
+    {PORTC, SIM_SCGC5_PORTC_MASK, 1U},  {PORTC, SIM_SCGC5_PORTC_MASK, 2U}
+};
+
+/* Channels scanned in turn by TSI0_IRQHandler(), set by TSIInit() */
+static INT8U tsiScanList[MAX_NUM_ELECTRODES];
+static INT8U tsiScanNum;
 
 static TOUCH_LEVEL_T tsiSensorLevels[MAX_NUM_ELECTRODES];
 static void tsiStartScan(INT8U channel);
-static void tsiProcScan(INT8U channel);
-static INT16U tsiSensorFlags = 0;
+static void tsiProcScan(INT8U channel, INT16U count);
+static void tsiTrack(TOUCH_LEVEL_T *const sensor);
+static void tsiSetThresholds(TOUCH_LEVEL_T *const sensor);
+static volatile INT16U tsiTouched = 0;      // Debounced touch state
+static volatile INT16U tsiSensorFlags = 0;
+static volatile INT16U tsiCalPending = 0;   // Channels to calibrate on next scan
+static INT8U tsiScanIdx;                    // tsiScanList[] index being scanned
+static void tsiSweepStart(void);
+
+/* eDMA sweep. When TSI_DMA_EN is 1 the end-of-scan event requests DMA channel 1, which
+ * copies the count into tsiDmaSamples[]. Channel 1 links to channel 0, which writes the
+ * next channel's start command from tsiDmaCmd[] to TSI0->DATA. The sweep runs with no
+ * CPU at all, and TSITask() averages the last TSI_DMA_DEPTH counts of each channel once
+ * per slice. tsiDmaSamples[] is sweep major: [sweep][tsiScanList[] index]. The result
+ * channel's major loop interrupt marks the buffer full after the first pass. */
+#define TSI_DMA_EN          0U
+#if TSI_DMA_EN
+#define TSI_DMA_RES_CH      1U      // Triggered by TSI0, copies the result
+#define TSI_DMA_CMD_CH      0U      // Linked from TSI_DMA_RES_CH, starts the next scan
+#define TSI_DMA_SRC         1U      // DMAMUX TSI0 source
+#define TSI_DMA_DEPTH       8U      // Counts averaged per channel
+#define TSI_DMA_DEPTH_SHIFT 3U
+static INT16U tsiDmaSamples[TSI_DMA_DEPTH*MAX_NUM_ELECTRODES];
+static INT32U tsiDmaCmd[MAX_NUM_ELECTRODES];
+static volatile INT8U tsiDmaValid;  // Sample buffer has been filled once
+void DMA1_DMA17_IRQHandler(void);
+#endif
+void TSI0_IRQHandler(void);
+
+/* Telemetry. While enabled, tsiProcScan() queues a TSI_TELEM_T for every scan it
+ * processes. The queue has one writer and one reader. When the reader falls behind
+ * new records are dropped, but seq still counts them so the gap can be seen. */
+#define TSI_TELEM_SIZE      32U     // Power of two
+#define TSI_TELEM_IDX_MASK  (TSI_TELEM_SIZE - 1U)
+static TSI_TELEM_T tsiTelemBuf[TSI_TELEM_SIZE];
+static volatile INT8U tsiTelemHead = 0;
+static volatile INT8U tsiTelemTail = 0;
+static INT8U tsiTelemSeq = 0;
+static volatile INT8U tsiTelemOn = FALSE;
+static void tsiTelemPut(INT8U channel, const TOUCH_LEVEL_T *const sensor);
 
 
 /********************************************************************************
- * K65TWR_TSI0Init: Initializes TSI0 module
+ * K65TWR_TSI0Init: Initializes TSI0 module and starts the first scan. From then
+ *                  on TSI0_IRQHandler() scans the electrodes continuously.
+ *                  elist - electrodes to scan, num - number of them, 1-16
  * Notes:
- *    -
+ *    - The pads must not be touched until they have been calibrated.
+ *    - Each electrode is refreshed once per num scans, so the refresh period
+ *      grows with the list but nothing blocks.
+ *    - Channels 1-4 are on PTA0-3, which are also the debug port pins.
  ********************************************************************************/
-void TSIInit(void){
+void TSIInit(const TSI_ELECTRODE_T *const elist, INT8U num){
+    INT8U i;
+    INT8U ch;
 
     SIM->SCGC5 |= SIM_SCGC5_TSI(1);         //Turn on clock to TSI module
-    SIM->SCGC5 |= SIM_SCGC5_PORTB(1);
+    if(num > MAX_NUM_ELECTRODES){
+        num = MAX_NUM_ELECTRODES;
+    }else{
+    }
+    tsiScanNum = 0;
+    for(i = 0; i < num; i++){
+        ch = (INT8U)(elist[i].channel & (MAX_NUM_ELECTRODES - 1U));
+        SIM->SCGC5 |= tsiPinTable[ch].scgc5;
+        tsiPinTable[ch].port->PCR[tsiPinTable[ch].pin] = PORT_PCR_MUX(0); //ALT0
+        tsiSensorLevels[ch].offset = elist[i].offset;
+        tsiScanList[tsiScanNum] = ch;
+        tsiScanNum++;
+    }
 
-    PORTB->PCR[18]=PORT_PCR_MUX(0);         //Set electrode pins to ALT0
-    PORTB->PCR[19]=PORT_PCR_MUX(0);
-    tsiSensorLevels[BRD_PAD1_CH].offset = E1_TOUCH_OFFSET;
-    tsiSensorLevels[BRD_PAD2_CH].offset = E2_TOUCH_OFFSET;
+    //Software trigger, interrupt at end of scan
+    TSI0->GENCS = TSI_GENCS_CFG|(TSI_GENCS_TSIIEN(1))|(TSI_GENCS_ESOR(1));
+    tsiMonNum = 0;
+
+    TSI0_ENABLE();
+    for(i = 0; i < tsiScanNum; i++){
+        TSIChCalibration(tsiScanList[i]);
+    }
+    NVIC_SetPriority(TSI0_IRQn, TSI_IRQ_PRIORITY);
+    NVIC_EnableIRQ(TSI0_IRQn);
+    tsiScanIdx = 0;
+    tsiSweepStart();
+}
 
+/********************************************************************************
+ *   TSITask: Cooperative task, call once per slice. With TSI_DMA_EN it takes the
+ *            mean of each channel's last TSI_DMA_DEPTH counts and runs the
+ *            touch detection on it. Otherwise the interrupt does everything.
+ ********************************************************************************/
+void TSITask(void){
+#if TSI_DMA_EN
+    INT8U i;
+    INT8U sweep;
+    INT32U sum;
+    if((tsiDmaValid == TRUE) && (tsiMonNum == 0)){
+        for(i = 0; i < tsiScanNum; i++){
+            sum = 0;
+            for(sweep = 0; sweep < TSI_DMA_DEPTH; sweep++){
+                sum += tsiDmaSamples[(sweep*tsiScanNum) + i];
+            }
+            tsiProcScan(tsiScanList[i], (INT16U)(sum>>TSI_DMA_DEPTH_SHIFT));
+        }
+    }else{
+    }
+#endif
+}
 
-    //16 consecutive scans, Prescale divide by 32, software trigger
-    //16uA ext. charge current, 16uA Ref. charge current, .592V dV
-    TSI0->GENCS = ((TSI_GENCS_EXTCHRG(5))|
-                   (TSI_GENCS_REFCHRG(5))|
-                   (TSI_GENCS_DVOLT(1))|
-                   (TSI_GENCS_PS(5))|
-                   (TSI_GENCS_NSCN(15)));
+/********************************************************************************
+ *   tsiSweepStart: Starts scanning the electrode list, either one scan for the
+ *                  interrupt to continue or the DMA sweep.
+ ********************************************************************************/
+static void tsiSweepStart(void){
+#if TSI_DMA_EN
+    INT8U i;
+    INT16U nsamp;
+    for(i = 0; i < tsiScanNum; i++){
+        tsiDmaCmd[i] = TSI_DATA_TSICH(tsiScanList[(i + 1U) % tsiScanNum])|
+                       TSI_DATA_DMAEN(1)|TSI_DATA_SWTS(1);
+    }
+    nsamp = (INT16U)(tsiScanNum*TSI_DMA_DEPTH);
+    tsiDmaValid = FALSE;
+    SIM->SCGC6 |= SIM_SCGC6_DMAMUX(1);
+    SIM->SCGC7 |= SIM_SCGC7_DMA(1);
+    DMAMUX->CHCFG[TSI_DMA_RES_CH] = 0;
+    DMA0->TCD[TSI_DMA_RES_CH].SADDR = DMA_SADDR_SADDR((INT32U)&TSI0->DATA); //TSICNT
+    DMA0->TCD[TSI_DMA_RES_CH].SOFF = DMA_SOFF_SOFF(0U);
+    DMA0->TCD[TSI_DMA_RES_CH].ATTR = (DMA_ATTR_SSIZE(1U)|DMA_ATTR_DSIZE(1U));
+    DMA0->TCD[TSI_DMA_RES_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(2U);
+    DMA0->TCD[TSI_DMA_RES_CH].SLAST = DMA_SLAST_SLAST(0U);
+    DMA0->TCD[TSI_DMA_RES_CH].DADDR = DMA_DADDR_DADDR((INT32U)&tsiDmaSamples[0]);
+    DMA0->TCD[TSI_DMA_RES_CH].DOFF = DMA_DOFF_DOFF(2U);
+    DMA0->TCD[TSI_DMA_RES_CH].CITER_ELINKYES = (DMA_CITER_ELINKYES_ELINK(1)|
+        DMA_CITER_ELINKYES_LINKCH(TSI_DMA_CMD_CH)|DMA_CITER_ELINKYES_CITER(nsamp));
+    DMA0->TCD[TSI_DMA_RES_CH].BITER_ELINKYES = (DMA_BITER_ELINKYES_ELINK(1)|
+        DMA_BITER_ELINKYES_LINKCH(TSI_DMA_CMD_CH)|DMA_BITER_ELINKYES_BITER(nsamp));
+    DMA0->TCD[TSI_DMA_RES_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(-(INT32S)(nsamp*2U));
+    DMA0->TCD[TSI_DMA_RES_CH].CSR = (DMA_CSR_MAJORELINK(1)|
+                                     DMA_CSR_MAJORLINKCH(TSI_DMA_CMD_CH)|
+                                     DMA_CSR_INTMAJOR(1));
+    DMA0->TCD[TSI_DMA_CMD_CH].SADDR = DMA_SADDR_SADDR((INT32U)&tsiDmaCmd[0]);
+    DMA0->TCD[TSI_DMA_CMD_CH].SOFF = DMA_SOFF_SOFF(4U);
+    DMA0->TCD[TSI_DMA_CMD_CH].ATTR = (DMA_ATTR_SSIZE(2U)|DMA_ATTR_DSIZE(2U));
+    DMA0->TCD[TSI_DMA_CMD_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(4U);
+    DMA0->TCD[TSI_DMA_CMD_CH].SLAST = DMA_SLAST_SLAST(-(INT32S)(tsiScanNum*4U));
+    DMA0->TCD[TSI_DMA_CMD_CH].DADDR = DMA_DADDR_DADDR((INT32U)&TSI0->DATA);
+    DMA0->TCD[TSI_DMA_CMD_CH].DOFF = DMA_DOFF_DOFF(0U);
+    DMA0->TCD[TSI_DMA_CMD_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(tsiScanNum);
+    DMA0->TCD[TSI_DMA_CMD_CH].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(tsiScanNum);
+    DMA0->TCD[TSI_DMA_CMD_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0U);
+    DMA0->TCD[TSI_DMA_CMD_CH].CSR = 0;
+    DMAMUX->CHCFG[TSI_DMA_RES_CH] = (DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_SOURCE(TSI_DMA_SRC));
+    NVIC_SetPriority(DMA1_DMA17_IRQn, TSI_IRQ_PRIORITY);
+    NVIC_EnableIRQ(DMA1_DMA17_IRQn);
+    DMA0->SERQ = DMA_SERQ_SERQ(TSI_DMA_RES_CH);
+    TSI0->DATA = TSI_DATA_TSICH(tsiScanList[0])|TSI_DATA_DMAEN(1);
+    TSI0->DATA |= TSI_DATA_SWTS(1);
+#else
+    tsiStartScan(tsiScanList[tsiScanIdx]);
+#endif
+}
 
-    TSI0_ENABLE();
-    TSIChCalibration(BRD_PAD1_CH);
-    TSIChCalibration(BRD_PAD2_CH);
+#if TSI_DMA_EN
+/********************************************************************************
+ *   DMA1_DMA17_IRQHandler: Result channel major loop done, every channel has
+ *                          TSI_DMA_DEPTH counts in tsiDmaSamples[].
+ ********************************************************************************/
+void DMA1_DMA17_IRQHandler(void){
+    DMA0->CINT = DMA_CINT_CINT(TSI_DMA_RES_CH);
+    tsiDmaValid = TRUE;
 }
+#endif
 
 /********************************************************************************
  *   TSICalibration: Calibration to find non-touch baseline for a channel
  *                   channel - the channel to calibrate, range 0-15
- *                   Note - the sensor must not be pressed when this is executed.
+ *                   Note - the sensor must not be pressed until the next scan
+ *                   of the channel completes. The baseline is taken from it.
  ********************************************************************************/
 void TSIChCalibration(INT8U channel){
-        tsiStartScan(channel);
-        while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0){} //wait for scan to finish
-        TSI0->GENCS |= TSI_GENCS_EOSF(1);    //Clear flag
-        tsiSensorLevels[channel].baseline = (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK);
-        tsiSensorLevels[channel].threshold = tsiSensorLevels[channel].baseline +
-                                             tsiSensorLevels[channel].offset;
+        tsiCalPending |= (INT16U)(1<<channel);
 }
 
 /********************************************************************************
- *   TSITask: Cooperative task for timeslice scheduler
- *            Processes and starts alternate sensors each time through to avoid
- *            blocking.
- *            In order to not block the task period should be > 5ms.
- *            To not miss a press, the task period should be < ~25ms.
-  ********************************************************************************/
-void TSITask(void){
-
-    static TSI_TASK_STATE_T tsiTaskState = PROC1START2;
+ *   TSI0_IRQHandler: End of scan. Reads the channel that finished, starts the
+ *                    next one in tsiScanList[] and then processes the result
+ *                    while the next channel converts.
+ ********************************************************************************/
+void TSI0_IRQHandler(void){
+    INT8U done_ch;
+    INT16U count;
+    TOUCH_LEVEL_T *sensor;
+    DB5_TURN_ON();
+    if(tsiMonNum != 0){                  //Monitor mode, hardware compare
+        done_ch = tsiMonList[tsiMonIdx];
+        sensor = &tsiSensorLevels[done_ch];
+        sensor->count = (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK);
+        if((TSI0->GENCS & TSI_GENCS_OUTRGF_MASK) != 0){
+            if(sensor->deb < TSI_DEB_SCANS){
+                sensor->deb++;
+            }else{
+            }
+            if(sensor->deb >= TSI_DEB_SCANS){
+                tsiSensorFlags |= (INT16U)(1<<done_ch);
+            }else{
+            }
+        }else{
+            sensor->deb = 0;
+            if(sensor->count < sensor->release){     //Released, follow the drift
+                tsiTrack(sensor);
+            }else{
+            }
+        }
+        TSI0->GENCS |= TSI_GENCS_OUTRGF(1)|TSI_GENCS_EOSF(1);
+        tsiMonIdx++;                     //Next channel and its new threshold
+        if(tsiMonIdx >= tsiMonNum){
+            tsiMonIdx = 0;
+        }else{
+        }
+        tsiMonSetCh(tsiMonList[tsiMonIdx]);
+    }else{
+        TSI0->GENCS |= TSI_GENCS_EOSF(1);    //Clear flag
+        done_ch = tsiScanList[tsiScanIdx];
+        count = (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK);
+        tsiScanIdx++;
+        if(tsiScanIdx >= tsiScanNum){
+            tsiScanIdx = 0;
+        }else{
+        }
+        tsiStartScan(tsiScanList[tsiScanIdx]);
+        tsiProcScan(done_ch, count);
+    }
+    DB5_TURN_OFF();
+}
 
-    tsiStartScan(BRD_PAD1_CH);
+/********************************************************************************
+ *   TSIMonitorStart: Stops the software scanning and lets the TSI hardware
+ *                    watch the channels in chmask against their thresholds.
+ *                    TSI_DEB_SCANS out-of-range scans in a row set the
+ *                    channel's bit in TSIGetSensorFlags().
+ *                    chmask - bit per channel, one or more channels
+ ********************************************************************************/
+void TSIMonitorStart(INT16U chmask){
+    INT8U ch;
+    NVIC_DisableIRQ(TSI0_IRQn);
+#if TSI_DMA_EN
+    DMA0->CERQ = DMA_CERQ_CERQ(TSI_DMA_RES_CH);
+    NVIC_DisableIRQ(DMA1_DMA17_IRQn);
+    DMA0->CINT = DMA_CINT_CINT(TSI_DMA_RES_CH);
+#endif
+    TSI0_DISABLE();                     //Abort the scan in progress
+    tsiMonNum = 0;
+    for(ch = 0; ch < MAX_NUM_ELECTRODES; ch++){
+        if((chmask & (INT16U)(1<<ch)) != 0){
+            tsiMonList[tsiMonNum] = ch;
+            tsiSensorLevels[ch].deb = 0;
+            tsiMonNum++;
+        }else{
+        }
+    }
+    if(tsiMonNum != 0){
+        //Hardware trigger, interrupt at end of scan
+        TSI0->GENCS = TSI_GENCS_CFG|(TSI_GENCS_TSIIEN(1))|(TSI_GENCS_STM(1))|
+                      (TSI_GENCS_STPE(1))|(TSI_GENCS_ESOR(1))|
+                      (TSI_GENCS_OUTRGF(1))|(TSI_GENCS_EOSF(1));
+        tsiMonIdx = 0;
+        tsiMonSetCh(tsiMonList[0]);
+        TSI0_ENABLE();
+        SIM->SCGC5 |= SIM_SCGC5_LPTMR(1);
+        LPTMR0->CSR = 0;
+        LPTMR0->PSR = LPTMR_PSR_PCS(TSI_LPTMR_LPO)|LPTMR_PSR_PBYP(1);
+        LPTMR0->CMR = LPTMR_CMR_COMPARE(TSI_MON_PERIOD_MS - 1U);
+        LPTMR0->CSR = LPTMR_CSR_TEN(1);
+    }else{                              //Nothing to watch, keep scanning
+        TSI0_ENABLE();
+        tsiSweepStart();
+    }
+    NVIC_EnableIRQ(TSI0_IRQn);
+}
 
-    DB2_TURN_ON();
-    switch(tsiTaskState){
-    case PROC1START2:
-        tsiProcScan(BRD_PAD1_CH);
-        DB1_TURN_ON();
-        tsiStartScan(BRD_PAD2_CH);
-        tsiTaskState = PROC2START1;
-        break;
-    case PROC2START1:
-        tsiProcScan(BRD_PAD2_CH);
-        DB1_TURN_OFF();
-        tsiStartScan(BRD_PAD1_CH);
-        tsiTaskState = PROC1START2;
-        break;
-    default:
-        tsiTaskState = PROC1START2;
-        break;
+/********************************************************************************
+ *   TSIMonitorStop: Stops monitor mode and goes back to software scanning of
+ *                   every channel.
+ ********************************************************************************/
+void TSIMonitorStop(void){
+    INT8U i;
+    if(tsiMonNum != 0){
+        NVIC_DisableIRQ(TSI0_IRQn);
+        LPTMR0->CSR = LPTMR_CSR_TCF(1);
+        TSI0_DISABLE();
+        for(i = 0; i < tsiMonNum; i++){ //Software debounce starts over
+            tsiSensorLevels[tsiMonList[i]].deb = 0;
+        }
+        tsiMonNum = 0;
+        TSI0->GENCS = TSI_GENCS_CFG|(TSI_GENCS_TSIIEN(1))|(TSI_GENCS_ESOR(1))|
+                      (TSI_GENCS_OUTRGF(1))|(TSI_GENCS_EOSF(1));
+        TSI0_ENABLE();
+        tsiSweepStart();
+        NVIC_EnableIRQ(TSI0_IRQn);
+    }else{
     }
-    DB2_TURN_OFF();
+}
 
+/********************************************************************************
+ *   tsiMonSetCh: Selects the channel for the next hardware triggered scan and
+ *                sets the out-of-range window to its threshold.
+ ********************************************************************************/
+static void tsiMonSetCh(INT8U channel){
+    TSI0->TSHD = TSI_TSHD_THRESH(tsiSensorLevels[channel].threshold)|TSI_TSHD_THRESL(0);
+    TSI0->DATA = TSI_DATA_TSICH(channel);
 }
 
 /********************************************************************************
@@ -117,32 +409,222 @@ static void tsiStartScan(INT8U channel){
 }
 
 /********************************************************************************
- *   TSIProcScan: Waits for the scan to complete, then sets the appropriate
- *                flags is a touch was detected.
- *                Note the scan must be started before this is called.
+ *   TSIProcScan: Saves the count of a finished scan, debounces the touch state
+ *                with hysteresis and sets the channel's flag while it is
+ *                touched. Untouched channels track their baseline. A pending
+ *                calibration restarts the channel from this count.
+ *                Called only from TSI0_IRQHandler().
  *                channel - the channel to be processed
+ *                count - its scan result
  ********************************************************************************/
-static void tsiProcScan(INT8U channel){
+static void tsiProcScan(INT8U channel, INT16U count){
 
-    while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0){}
-    TSI0->GENCS |= TSI_GENCS_EOSF(1);    //Clear flag
+    TOUCH_LEVEL_T *sensor = &tsiSensorLevels[channel];
+    INT16U chbit = (INT16U)(1<<channel);
+    sensor->count = count;
+    if((tsiCalPending & chbit) != 0){
+        sensor->baseq = (INT32U)sensor->count<<TSI_FRAC_BITS;
+        sensor->baseline = sensor->count;
+        sensor->noiseq = 0;
+        sensor->deb = 0;
+        tsiSetThresholds(sensor);
+        tsiTouched &= (INT16U)~chbit;
+        tsiCalPending &= (INT16U)~chbit;
+    }else if((tsiTouched & chbit) != 0){
+        if(sensor->count < sensor->release){
+            sensor->deb++;
+        }else{
+            sensor->deb = 0;
+        }
+        if(sensor->deb >= TSI_DEB_SCANS){
+            tsiTouched &= (INT16U)~chbit;
+            sensor->deb = 0;
+        }else{
+        }
+    }else{
+        if(sensor->count > sensor->threshold){
+            sensor->deb++;
+        }else{
+            sensor->deb = 0;
+            if(sensor->count < sensor->release){     //Not an approaching finger
+                tsiTrack(sensor);
+            }else{
+            }
+        }
+        if(sensor->deb >= TSI_DEB_SCANS){
+            tsiTouched |= chbit;
+            sensor->deb = 0;
+        }else{
+        }
+    }
+    if((tsiTouched & chbit) != 0){
+        tsiSensorFlags |= chbit;        //Held until read
+    }else{
+    }
+    if(tsiTelemOn == TRUE){
+        tsiTelemPut(channel, sensor);
+    }else{
+    }
+
+}
+
+/********************************************************************************
+ *   tsiTelemPut: Queues a telemetry record of a processed scan.
+ ********************************************************************************/
+static void tsiTelemPut(INT8U channel, const TOUCH_LEVEL_T *const sensor){
+    INT8U head = tsiTelemHead;
+    INT8U next = (INT8U)((head + 1U) & TSI_TELEM_IDX_MASK);
+    if(next != tsiTelemTail){
+        tsiTelemBuf[head].seq = tsiTelemSeq;
+        tsiTelemBuf[head].channel = channel;
+        if((tsiTouched & (INT16U)(1<<channel)) != 0){
+            tsiTelemBuf[head].channel |= TSI_TELEM_TOUCHED;
+        }else{
+        }
+        tsiTelemBuf[head].count = sensor->count;
+        tsiTelemBuf[head].baseline = sensor->baseline;
+        tsiTelemBuf[head].threshold = sensor->threshold;
+        tsiTelemHead = next;
+    }else{                              //Full, dropped
+    }
+    tsiTelemSeq++;
+}
+
+/********************************************************************************
+ *   TSITelemEnable: Starts or stops queuing telemetry records. Starting
+ *                   empties the queue and restarts seq at 0.
+ *                   enable - TRUE or FALSE
+ ********************************************************************************/
+void TSITelemEnable(INT8U enable){
+    tsiTelemOn = FALSE;
+    tsiTelemTail = tsiTelemHead;
+    tsiTelemSeq = 0;
+    tsiTelemOn = enable;
+}
 
-    /* Process electrode 1 */
-    if((INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK) > tsiSensorLevels[channel].threshold){
-        tsiSensorFlags |= (INT16U)(1<<channel);
+/********************************************************************************
+ *   TSITelemGet: Takes the oldest telemetry record from the queue.
+ *                rec - where the record is copied
+ *                Returns TRUE if a record was copied, FALSE if none waiting
+ ********************************************************************************/
+INT8U TSITelemGet(TSI_TELEM_T *const rec){
+    INT8U got;
+    INT8U tail = tsiTelemTail;
+    if(tail != tsiTelemHead){
+        *rec = tsiTelemBuf[tail];
+        tsiTelemTail = (INT8U)((tail + 1U) & TSI_TELEM_IDX_MASK);
+        got = TRUE;
     }else{
-        tsiSensorFlags &= (INT16U)~(1<<channel);
+        got = FALSE;
     }
+    return got;
+}
 
+/********************************************************************************
+ *   tsiTrack: Moves the baseline and the noise estimate toward the last count.
+ ********************************************************************************/
+static void tsiTrack(TOUCH_LEVEL_T *const sensor){
+    INT32S diff;
+    INT32U dev;
+    diff = ((INT32S)sensor->count<<TSI_FRAC_BITS) - (INT32S)sensor->baseq;
+    sensor->baseq = (INT32U)((INT32S)sensor->baseq + (diff>>TSI_BASE_SHIFT));
+    sensor->baseline = (INT16U)(sensor->baseq>>TSI_FRAC_BITS);
+    if(diff < 0){
+        dev = (INT32U)(-diff);
+    }else{
+        dev = (INT32U)diff;
+    }
+    if(dev > 0xFFFFU){
+        dev = 0xFFFFU;
+    }else{
+    }
+    sensor->noiseq = (INT16U)((INT32S)sensor->noiseq +
+                     (((INT32S)dev - (INT32S)sensor->noiseq)>>TSI_NOISE_SHIFT));
+    tsiSetThresholds(sensor);
 }
 
 /********************************************************************************
- *   TSIGetSensorFlags: Returns value of sensor flag variable and clears it
- *                      to receive sensor press only one time.
+ *   tsiSetThresholds: Sets the touch and release levels from the baseline and
+ *                     the noise estimate. The offset set in TSIInit() is the
+ *                     least the threshold can be above the baseline.
+ ********************************************************************************/
+static void tsiSetThresholds(TOUCH_LEVEL_T *const sensor){
+    INT32U delta;
+    INT32U level;
+    delta = ((INT32U)sensor->noiseq*TSI_NOISE_MULT)>>TSI_FRAC_BITS;
+    if(delta < sensor->offset){
+        delta = sensor->offset;
+    }else{
+    }
+    level = sensor->baseline + delta;
+    if(level > TSI_DATA_TSICNT_MASK){
+        level = TSI_DATA_TSICNT_MASK;
+    }else{
+    }
+    sensor->threshold = (INT16U)level;
+    sensor->release = (INT16U)(sensor->baseline + (delta/2U));
+}
+
+/********************************************************************************
+ *   TSIPeekSensorFlags: Returns the channels touched since the last
+ *                       TSIGetSensorFlags() call without clearing them.
+ ********************************************************************************/
+INT16U TSIPeekSensorFlags(void){
+    return tsiSensorFlags;
+}
+
+/********************************************************************************
+ *   TSIGetSensorFlags: Returns the channels touched since the last call and
+ *                      clears them to receive sensor press only one time.
  ********************************************************************************/
 INT16U TSIGetSensorFlags(void){
     INT16U sflags;
+    NVIC_DisableIRQ(TSI0_IRQn);
     sflags = tsiSensorFlags;
     tsiSensorFlags = 0;
+    NVIC_EnableIRQ(TSI0_IRQn);
     return sflags;
 }
+
+/********************************************************************************
+ *   TSIGetSensorLevel: Returns the last scan count of a channel above its
+ *                      baseline as a percent of the touch offset, 0-100.
+ *                      channel - the channel to read, range 0-15
+ ********************************************************************************/
+INT8U TSIGetSensorLevel(INT8U channel){
+    INT8U level;
+    INT16U delta;
+    TOUCH_LEVEL_T *sensor = &tsiSensorLevels[channel];
+    if(sensor->count <= sensor->baseline){
+        level = 0;
+    }else{
+        delta = sensor->count - sensor->baseline;
+        if(delta >= sensor->offset){
+            level = 100U;
+        }else{
+            level = (INT8U)(((INT32U)delta*100U)/sensor->offset);
+        }
+    }
+    return level;
+}
+
+/********************************************************************************
+ *   TSIGetSensorData: Copies the last count, baseline and threshold of a
+ *                     channel in telemetry record form. seq is not used.
+ *                     channel - the channel to read, range 0-15
+ *                     data - where the values are copied
+ ********************************************************************************/
+void TSIGetSensorData(INT8U channel, TSI_TELEM_T *const data){
+    TOUCH_LEVEL_T *sensor = &tsiSensorLevels[channel];
+    NVIC_DisableIRQ(TSI0_IRQn);
+    data->seq = 0;
+    data->channel = channel;
+    if((tsiTouched & (INT16U)(1<<channel)) != 0){
+        data->channel |= TSI_TELEM_TOUCHED;
+    }else{
+    }
+    data->count = sensor->count;
+    data->baseline = sensor->baseline;
+    data->threshold = sensor->threshold;
+    NVIC_EnableIRQ(TSI0_IRQn);
+}
@@ -3,10 +3,35 @@
 
 #define BRD_PAD1_CH  12U
 #define BRD_PAD2_CH  11U
+#define BRD_PAD1_OFFSET  0x0400U    // Touch offset from baseline
+#define BRD_PAD2_OFFSET  0x0400U    // Determined experimentally
 
-void TSIInit(void);
+/* One entry of the electrode list given to TSIInit() */
+typedef struct{
+    INT8U channel;      // TSI0 channel, 0-15
+    INT16U offset;      // Typical touch count above the baseline
+}TSI_ELECTRODE_T;
+
+/* Telemetry record of one processed scan, see TSITelemGet() */
+#define TSI_TELEM_TOUCHED 0x80U     // channel bit set while debounced touched
+typedef struct{
+    INT8U seq;          // Counts every scan, gaps are dropped records
+    INT8U channel;      // TSI0 channel | TSI_TELEM_TOUCHED
+    INT16U count;
+    INT16U baseline;
+    INT16U threshold;
+}TSI_TELEM_T;
+
+void TSIInit(const TSI_ELECTRODE_T *const elist, INT8U num);
 void TSIChCalibration(INT8U channel);
 INT16U TSIGetSensorFlags(void);
+INT16U TSIPeekSensorFlags(void);
 void TSITask(void);
+INT8U TSIGetSensorLevel(INT8U channel);
+void TSIMonitorStart(INT16U chmask);
+void TSIMonitorStop(void);
+void TSITelemEnable(INT8U enable);
+INT8U TSITelemGet(TSI_TELEM_T *const rec);
+void TSIGetSensorData(INT8U channel, TSI_TELEM_T *const data);
 
 #endif
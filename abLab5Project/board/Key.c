@@ -1,8 +1,8 @@
 /****************************************************************************************
-* Key.c - A keypad module for a 4x4 matrix keypad. This version allows for multiple
-*         column keys to be pressed and mapped to a different code by changing ColTable[]
-*         in KeyScan().
-*         Multiple rows can not be resolved. The topmost button will be used.
+* Key.c - A keypad module for a 4x4 matrix keypad. Every scan reads all rows into a
+*         16-bit key map, bit = (row-1)*4 + (col-1), and each key is debounced on its own
+*         so any number of keys can be held. Combinations that the diode-less matrix can
+*         not resolve (ghosting) are detected and ignored.
 *         The KeyCoeTable[] is currently set to generate ASCII codes.
 * 02/20/2001 TDM Original key.c for 9S12
 * 01/14/2013 TDM Modified for K70 custom tower board.
@@ -11,20 +11,37 @@
 *            from B60 to A64 on the tower. Also, PORTA bit 6 must remain an unsued input.
 * 12/08/2015 Changed type for control codes.
 * 10/29/2018 Modified for MCUXpresso, Todd Morton
+* 10/18/2026 Added pin interrupt wake-up so the keypad is not scanned while idle.
+* 10/18/2026 Full matrix scan with per-key debounce, ghost detection and key edges.
+* 10/18/2026 Replaced keyBuffer with a timestamped event FIFO, added long-press and
+*            auto-repeat.
+* 10/18/2026 Replaced keyDly() loop with a DWT cycle count settle delay.
+* 10/18/2026 Settle cycles follow the core clock, KeyClkChange().
+* 10/18/2026 Added KeyIdle() and KeyWake() for LLWU wake-up from low-leakage stop.
 *****************************************************************************************
 * Project master header file
 ****************************************************************************************/
 #include "MCUType.h"
 #include "Key.h"
 #include "K65TWR_GPIO.h"
+#include "SysTickDelay.h"
+#include "K65TWR_ClkCfg.h"
 /****************************************************************************************
 * Private Resources
 ****************************************************************************************/
-static INT8U keyScan(void);         /* Makes a single keypad scan  */
-static INT8C keyBuffer;             /* Holds the ASCII code for key*/
+static INT16U keyScan(void);        /* Makes a single keypad scan  */
+static INT8U keyGhosted(const INT16U kmap);
 static const INT8C keyCodeTable[16] =
    {'1','2','3',DC1,'4','5','6',DC2,'7','8','9',DC3,'*','0','#',DC4};
-static void keyDly(void);           /* Added for GPIO to settle before read */
+static INT8U keyColsIn(void);       /* Waits for GPIO to settle, reads columns */
+static void keyWakeArm(void);       /* Stops scanning until a column edge */
+static volatile INT8U keyAwake;     /* Scanning until all keys are released */
+static INT16U keyDown;              /* Debounced key map */
+static INT16U keyPressEdges;        /* Keys pressed since last KeyGetPressEdges() */
+static INT16U keyReleaseEdges;      /* Keys released since last KeyGetReleaseEdges() */
+static INT8U keyGhost;              /* Last scan was ambiguous */
+static void keyEvPut(const INT8U kidx, const KEY_EV_TYPE type, const INT32U time);
+static void keyHoldUpdate(const INT16U new_down, const INT32U now);
 /****************************************************************************************
 * Module Defines
 * This version is designed for the custom LCD/Keypad board, which has the following
@@ -32,27 +49,109 @@ static void keyDly(void);           /* Added for GPIO to settle before read */
 *  COL1->PTC3, COL2->PTC4, COL3->PTC5, COL4->PTC6
 *  ROW1->PTC7, ROW2->PTC8, ROW3->PTC9, ROW4->PTC10
 ****************************************************************************************/
-typedef enum{KEY_OFF,KEY_EDGE,KEY_VERF} KEYSTATES;
 #define KEY_PORT_OUT   GPIOC->PDOR
 #define KEY_PORT_DIR   GPIOC->PDDR
 #define KEY_PORT_IN	   GPIOC->PDIR
 #define COLS_MASK 0x00000078U
 #define ROWS_MASK 0x00000780U
 #define COLS_IN() (((~KEY_PORT_IN) & COLS_MASK)>>3)
+#define KEY_NUM_ROWS   4U
+#define KEY_NUM_COLS   4U
+#define KEY_ROW_MAP(kmap,row) (((kmap)>>((row)*KEY_NUM_COLS)) & 0x0FU)
 /****************************************************************************************
-* KeyGet() - This function provides public access to keyBuffer. It clears keyBuffer
-*            after for read-once handshaking. Note: this handshaking method only works
-*            when 0x00 is not a valid keycode. If it is a valid keycode then a semaphore
-*            should be added.
+* Column settle time, converted to core cycles for the DWT cycle counter. KEY_SETTLE_NS
+* is the old keyDly() time. Set KEY_SETTLE_SAMPLE_EN to 1 to stop waiting as soon as the
+* columns are stable after KEY_SETTLE_MIN_NS, which allows for the slow pull-up rise of
+* the column released by the previous row.
+****************************************************************************************/
+#define KEY_SETTLE_NS         850U
+#define KEY_SETTLE_MIN_NS     250U
+#define KEY_SETTLE_SAMPLE_EN  0U
+#define KEY_STABLE_READS      3U
+#define KEY_NS_TO_CYC(hz,ns)  (((((hz)+999999U)/1000000U)*(ns)+999U)/1000U)    /* Rounded up */
+static INT32U keySettleCyc = KEY_NS_TO_CYC(K65TWR_CORE_CLK_HZ, KEY_SETTLE_NS);
+static INT32U keySettleMinCyc = KEY_NS_TO_CYC(K65TWR_CORE_CLK_HZ, KEY_SETTLE_MIN_NS);
+/****************************************************************************************
+* Key Event FIFO
+* KeyTask() queues an event for every press and release plus long-press and repeat events
+* for the most recently pressed key. A long-press is sent once after keyLongMs, then
+* repeats every keyRepeatMs while it is held. If the FIFO is full new events are dropped.
+****************************************************************************************/
+#define KEY_EVQ_SIZE       16U      /* Must be a power of two */
+#define KEY_EVQ_MASK       (KEY_EVQ_SIZE - 1U)
+#define KEY_LONG_MS_DEF    1000U
+#define KEY_REPEAT_MS_DEF  200U
+#define KEY_NO_HOLD        0xFFU
+
+static KEY_EVENT keyEvQueue[KEY_EVQ_SIZE];
+static INT8U keyEvHead;
+static INT8U keyEvTail;
+static INT16U keyLongMs;
+static INT16U keyRepeatMs;
+static INT8U keyHoldIdx;            /* Key checked for long-press, KEY_NO_HOLD if none */
+static INT8U keyHoldLong;           /* Long-press already sent */
+static INT32U keyHoldTime;          /* Time of press or of last long/repeat event */
+/****************************************************************************************
+* Wake-up Mode
+* When KEY_WAKE_EN is 1 and no key is pressed, all rows are driven low and the column pins
+* interrupt on either edge. Nothing is scanned until PORTC_IRQHandler() sees an edge, then
+* KeyTask() scans every slice until all keys are released again.
+* Note: PORTC_IRQHandler() is owned by this module. Other PORTC pins must not use IRQC.
+****************************************************************************************/
+#define KEY_WAKE_EN       1U
+#define KEY_IRQ_PRIORITY  3U
+#define KEY_PCR_COL       (PORT_PCR_MUX(1)|PORT_PCR_PS_MASK|PORT_PCR_PE_MASK)
+#define KEY_IRQC_EITHER   0xBU
+#if KEY_WAKE_EN
+void PORTC_IRQHandler(void);        /* Not static so the linker can see it */
+#endif
+#define KEY_COL_IRQ_SET(irqc) {PORTC->PCR[3] = KEY_PCR_COL|PORT_PCR_IRQC(irqc); \
+                               PORTC->PCR[4] = KEY_PCR_COL|PORT_PCR_IRQC(irqc); \
+                               PORTC->PCR[5] = KEY_PCR_COL|PORT_PCR_IRQC(irqc); \
+                               PORTC->PCR[6] = KEY_PCR_COL|PORT_PCR_IRQC(irqc);}
+/****************************************************************************************
+* KeyGetEvent() - Copies the oldest key event to *event and removes it from the FIFO.
+*                 Returns TRUE if there was an event, FALSE if the FIFO was empty.
+* - Public
+****************************************************************************************/
+INT8U KeyGetEvent(KEY_EVENT *const event){
+    INT8U got = FALSE;
+    if(keyEvTail != keyEvHead){
+        *event = keyEvQueue[keyEvTail];
+        keyEvTail = (INT8U)((keyEvTail + 1U) & KEY_EVQ_MASK);
+        got = TRUE;
+    }else{
+    }
+    return got;
+}
+
+/****************************************************************************************
+* KeyGet() - Returns the code of the next press or repeat event, skipping release and
+*            long-press events. Returns zero if there is none. Presses are queued so
+*            none are lost between calls. Do not mix with KeyGetEvent().
 * - Public
 ****************************************************************************************/
 INT8C KeyGet(void){
-    INT8C key;
-    key = keyBuffer;
-    keyBuffer = '\0';
+    INT8C key = '\0';
+    KEY_EVENT event;
+    while((key == '\0') && (KeyGetEvent(&event) == TRUE)){
+        if((event.type == KEY_EV_PRESS) || (event.type == KEY_EV_REPEAT)){
+            key = event.code;
+        }else{
+        }
+    }
     return (key);
 }
 
+/****************************************************************************************
+* KeySetTiming() - Sets the long-press time and the repeat period in ms. Zero disables.
+* - Public
+****************************************************************************************/
+void KeySetTiming(const INT16U long_ms, const INT16U repeat_ms){
+    keyLongMs = long_ms;
+    keyRepeatMs = repeat_ms;
+}
+
 /****************************************************************************************
 * KeyInit() - Initialization routine for the keypad module. The columns are normally set
 *             as inputs and, since they are pulled high, they are one. Then to pull a row
@@ -71,97 +170,328 @@ void KeyInit(void){
     PORTC->PCR[9]=PORT_PCR_MUX(1);
     PORTC->PCR[10]=PORT_PCR_MUX(1);
     KEY_PORT_OUT &= ~ROWS_MASK;            /* Preset all rows to zero    */
-    keyBuffer = '\0';                      /* Init keyBuffer      */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;     /* DWT cycle counter on */
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    keyEvHead = 0;                         /* Init event FIFO     */
+    keyEvTail = 0;
+    keyLongMs = KEY_LONG_MS_DEF;
+    keyRepeatMs = KEY_REPEAT_MS_DEF;
+    keyHoldIdx = KEY_NO_HOLD;
+    keyDown = 0;
+    keyPressEdges = 0;
+    keyReleaseEdges = 0;
+    keyGhost = FALSE;
+    keyAwake = 1;                          /* First KeyTask() arms the wake-up */
+#if KEY_WAKE_EN
+    NVIC_SetPriority(PORTC_IRQn, KEY_IRQ_PRIORITY);
+    NVIC_EnableIRQ(PORTC_IRQn);
+#endif
 }
 
 /****************************************************************************************
-* KeyTask() - Reads the keypad and updates keyBuffer. A task decomposed into states for
-*             detecting and verifying keypresses. This task should be called periodically
-*             with a period between: Tb/2 < Tp < (Tact-Tb)/2
-*             The switch must be released to have multiple acknowledged presses.
+* KeyTask() - Reads the keypad and updates the debounced key map. A key changes state
+*             after it reads the same on two scans in a row. This task should be called
+*             periodically with a period between: Tb/2 < Tp < (Tact-Tb)/2
+*             A scan with ghosting is discarded so phantom keys are never reported.
+*             Key events are queued in key map bit order, releases before presses.
 * (Public)
 ****************************************************************************************/
 void KeyTask(void) {
 	DB2_TURN_ON();
-    INT8U cur_key;
-    static INT8U last_key = 0;
-    static KEYSTATES keyState = KEY_OFF;
-
-    cur_key = keyScan();
-    if(keyState == KEY_OFF){    /* Key released state */
-        if(cur_key != 0){
-            keyState = KEY_EDGE;
-        }else{ /* wait for key press */
-        }
-    }else if(keyState == KEY_EDGE){     /* Keypress detected state*/
-        if(cur_key == last_key){        /* Keypress verified */
-            keyState = KEY_VERF;
-            keyBuffer = keyCodeTable[cur_key - 1]; /*update buffer */
-        }else if(cur_key == 0){        /* Unvalidated, start over */
-            keyState = KEY_OFF;
-        }else{                          /*Unvalidated, diff key edge*/
+    INT16U cur_map;
+    INT16U stable;
+    INT16U last_down;
+    INT16U new_down;
+    INT8U kbit;
+    INT32U now;
+    static INT16U last_map = 0;
+
+    if(keyAwake != 0){
+        now = SysTickGetmsCount();
+        cur_map = keyScan();
+        keyGhost = keyGhosted(cur_map);
+        if(keyGhost == FALSE){
+            stable = (INT16U)~(cur_map ^ last_map);     /* Same on both scans */
+            last_down = keyDown;
+            keyDown = (INT16U)((keyDown & ~stable)|(cur_map & stable));
+            new_down = (INT16U)(keyDown & ~last_down);
+            keyPressEdges |= new_down;
+            keyReleaseEdges |= (INT16U)(last_down & ~keyDown);
+            for(kbit = 0; kbit < (KEY_NUM_ROWS*KEY_NUM_COLS); kbit++){
+                if(((last_down & ~keyDown) & (1U<<kbit)) != 0){
+                    keyEvPut(kbit, KEY_EV_RELEASE, now);
+                }else{
+                }
+            }
+            for(kbit = 0; kbit < (KEY_NUM_ROWS*KEY_NUM_COLS); kbit++){
+                if((new_down & (1U<<kbit)) != 0){
+                    keyEvPut(kbit, KEY_EV_PRESS, now);
+                }else{
+                }
+            }
+            keyHoldUpdate(new_down, now);
+            last_map = cur_map;         /* Save map for next time */
+        }else{ /* Ambiguous, keep the last debounced state */
         }
-    }else if(keyState == KEY_VERF){     /* Keypress verified state */
-        if((cur_key == 0) || (cur_key != last_key)){
-            keyState = KEY_OFF;
-        }else{ /* wait for release or key change */
+        if((keyDown == 0) && (cur_map == 0)){
+            keyWakeArm();               /* All released, wait for an edge */
+        }else{
         }
-    }else{ /* In case of error */
-        keyState = KEY_OFF;             /* Should never get here */
+    }else{ /* Idle, no key touched since last release */
     }
-    last_key = cur_key;                 /* Save key for next time */
     DB2_TURN_OFF();
 }
 
 /****************************************************************************************
-* keyScan() - Scans the keypad and returns a keycode.
+* KeyGetPressed() - Returns the debounced key map. See KEY_BIT() in Key.h.
+* (Public)
+****************************************************************************************/
+INT16U KeyGetPressed(void){
+    return keyDown;
+}
+
+/****************************************************************************************
+* KeyGetPressEdges() - Returns the keys pressed since the last call, then clears them.
+* (Public)
+****************************************************************************************/
+INT16U KeyGetPressEdges(void){
+    INT16U edges;
+    edges = keyPressEdges;
+    keyPressEdges = 0;
+    return edges;
+}
+
+/****************************************************************************************
+* KeyGetReleaseEdges() - Returns the keys released since the last call, then clears them.
+* (Public)
+****************************************************************************************/
+INT16U KeyGetReleaseEdges(void){
+    INT16U edges;
+    edges = keyReleaseEdges;
+    keyReleaseEdges = 0;
+    return edges;
+}
+
+/****************************************************************************************
+* KeyGhosting() - Returns TRUE if the last scan could not be resolved. The key map is
+*                 frozen until the ambiguous combination is released.
+* (Public)
+****************************************************************************************/
+INT8U KeyGhosting(void){
+    return keyGhost;
+}
+
+/****************************************************************************************
+* keyHoldUpdate() - Tracks the most recently pressed key for long-press and repeat.
+*                   new_down - keys pressed on this scan, now - current ms count.
+* (Private)
+****************************************************************************************/
+static void keyHoldUpdate(const INT16U new_down, const INT32U now){
+    INT8U kbit;
+    for(kbit = (KEY_NUM_ROWS*KEY_NUM_COLS); kbit > 0; kbit--){
+        if((new_down & (1U<<(kbit - 1U))) != 0){
+            keyHoldIdx = (INT8U)(kbit - 1U);        /* Lowest new key */
+            keyHoldTime = now;
+            keyHoldLong = FALSE;
+        }else{
+        }
+    }
+    if((keyHoldIdx != KEY_NO_HOLD) && ((keyDown & (1U<<keyHoldIdx)) == 0)){
+        keyHoldIdx = KEY_NO_HOLD;                   /* Released */
+    }else{
+    }
+    if(keyHoldIdx != KEY_NO_HOLD){
+        if(keyHoldLong == FALSE){
+            if((keyLongMs != 0) && ((now - keyHoldTime) >= keyLongMs)){
+                keyEvPut(keyHoldIdx, KEY_EV_LONG, now);
+                keyHoldLong = TRUE;
+                keyHoldTime = now;
+            }else{
+            }
+        }else if((keyRepeatMs != 0) && ((now - keyHoldTime) >= keyRepeatMs)){
+            keyEvPut(keyHoldIdx, KEY_EV_REPEAT, now);
+            keyHoldTime += keyRepeatMs;
+        }else{
+        }
+    }else{
+    }
+}
+
+/****************************************************************************************
+* keyEvPut() - Queues an event for key map bit kidx. Dropped if the FIFO is full.
+* (Private)
+****************************************************************************************/
+static void keyEvPut(const INT8U kidx, const KEY_EV_TYPE type, const INT32U time){
+    INT8U next;
+    next = (INT8U)((keyEvHead + 1U) & KEY_EVQ_MASK);
+    if(next != keyEvTail){
+        keyEvQueue[keyEvHead].code = keyCodeTable[kidx];
+        keyEvQueue[keyEvHead].type = type;
+        keyEvQueue[keyEvHead].time = time;
+        keyEvHead = next;
+    }else{ /* Full, drop */
+    }
+}
+
+/****************************************************************************************
+* keyScan() - Scans every row of the keypad and returns a key map.
 *           - Designed for 4x4 keypad with columns pulled high.
-*           - Current keycodes follow:
-*               1->0x01,2->0x02,3->0x03,A->0x04
-*               4->0x05,5->0x06,6->0x07,B->0x08
-*               7->0x09,8->0x0A,9->0x0B,C->0x0C
-*               *->0x0D,0->0x0E,#->0x0F,D->0x10
+*           - Key map bits follow:
+*               1->bit0, 2->bit1, 3->bit2, A->bit3
+*               4->bit4, 5->bit5, 6->bit6, B->bit7
+*               7->bit8, 8->bit9, 9->bit10,C->bit11
+*               *->bit12,0->bit13,#->bit14,D->bit15
 *           - Returns zero if no key is pressed.
-*           - ColTable[] can be changed to distinguish multiple keys
-*             pressed in the same row.
 * (Private)
 ****************************************************************************************/
-static INT8U keyScan(void) {
+static INT16U keyScan(void) {
 
-    INT8U kcode;
+    INT16U kmap;
     INT8U roff;
     INT32U rbit;
 
-    const INT8U ColTable[16] = {0,1,2,2,3,3,3,3,4,4,4,4,4,4,4,4};
-
+    kmap = 0;
     rbit = 0x00000080U;
     roff = 0x00U;
     while(rbit != 0){ /* Until all rows are scanned */
         KEY_PORT_OUT &= ~ROWS_MASK;
         KEY_PORT_DIR = (KEY_PORT_DIR & ~ROWS_MASK)|rbit;    /* Pull row low */
-        keyDly();	// wait for direction and col inputs to settle
-        kcode = (INT8U)(COLS_IN());  /*Read columns */
-        KEY_PORT_DIR = (KEY_PORT_DIR &~ROWS_MASK); 
-        if(kcode != 0){        /* generate key code if key pressed */
-            kcode = (INT8U)(roff + ColTable[kcode]);
-            break;
-        }else{}
+        kmap |= (INT16U)(keyColsIn()<<roff);  /* Read columns when settled */
+        KEY_PORT_DIR = (KEY_PORT_DIR &~ROWS_MASK);
         rbit = ROWS_MASK & (rbit<<1);       /* setup for next row */
-        roff = (INT8U)(roff + 4);
+        roff = (INT8U)(roff + KEY_NUM_COLS);
+    }
+    return (kmap);
+}
+
+/****************************************************************************************
+* keyGhosted() - Returns TRUE if the key map may hold a phantom key. With no diodes, when
+*                two rows share two or more pressed columns, a fourth corner of the
+*                rectangle reads as pressed whether it is or not.
+* (Private)
+****************************************************************************************/
+static INT8U keyGhosted(const INT16U kmap){
+    INT8U ra;
+    INT8U rb;
+    INT8U common;
+    INT8U ghost = FALSE;
+    for(ra = 0; ra < (KEY_NUM_ROWS - 1U); ra++){
+        for(rb = (INT8U)(ra + 1U); rb < KEY_NUM_ROWS; rb++){
+            common = (INT8U)(KEY_ROW_MAP(kmap,ra) & KEY_ROW_MAP(kmap,rb));
+            if((common & (INT8U)(common - 1U)) != 0){     /* Two or more bits */
+                ghost = TRUE;
+            }else{
+            }
+        }
+    }
+    return ghost;
+}
+
+/****************************************************************************************
+* keyWakeArm() - Drives all rows low and enables the column edge interrupts. If a key was
+*                pressed while arming, scanning continues instead. Does nothing if
+*                KEY_WAKE_EN is 0 so KeyTask() scans every slice.
+* (Private)
+****************************************************************************************/
+static void keyWakeArm(void){
+#if KEY_WAKE_EN
+    KEY_PORT_OUT &= ~ROWS_MASK;
+    KEY_PORT_DIR |= ROWS_MASK;              /* All rows low */
+    (void)keyColsIn();                      /* Settle before enabling edges */
+    keyAwake = 0;
+    PORTC->ISFR = COLS_MASK;
+    KEY_COL_IRQ_SET(KEY_IRQC_EITHER);
+    if(COLS_IN() != 0){                     /* Pressed while arming */
+        KEY_COL_IRQ_SET(0U);
+        keyAwake = 1;
+    }else{
     }
-    return (kcode); 
-}
-/****************************************************************************************
- * KeyDly() a software delay for KeyScan() to wait until port row bit direction and
- * column inputs are settled.
- * With debug bits included and a 180Mhz bus the delay is
- * 	Tdly = (55.5ns)i + 85ns
- * Currently set to ~862ns with i=14.
- * TDM 01/20/2013
- * Modified for 180MHz bus. Todd Morton 11/04/2015
- ****************************************************************************************/
-static void keyDly(void){
-	INT32U i;
-	for(i=0;i<14;i++){
-	}
+#endif
+}
+
+/****************************************************************************************
+* KeyIdle() - Returns TRUE while waiting for a column edge with all rows driven low, so
+*             a press pulls a column low with no scanning. Always FALSE if KEY_WAKE_EN
+*             is 0.
+* (Public)
+****************************************************************************************/
+INT8U KeyIdle(void){
+    INT8U idle = FALSE;
+#if KEY_WAKE_EN
+    if(keyAwake == 0){
+        idle = TRUE;
+    }else{
+    }
+#endif
+    return idle;
+}
+
+/****************************************************************************************
+* KeyWake() - Starts scanning as PORTC_IRQHandler() does. For a column edge seen by the
+*             LLWU, which the port interrupt may have missed while its clock was off.
+* (Public)
+****************************************************************************************/
+void KeyWake(void){
+#if KEY_WAKE_EN
+    KEY_COL_IRQ_SET(0U);
+    PORTC->ISFR = COLS_MASK;
+    keyAwake = 1;
+#endif
+}
+
+#if KEY_WAKE_EN
+/****************************************************************************************
+* PORTC_IRQHandler() - A column changed while idle. Disables the column interrupts, since
+*                      scanning toggles the columns, and wakes KeyTask().
+****************************************************************************************/
+void PORTC_IRQHandler(void){
+    KEY_COL_IRQ_SET(0U);
+    PORTC->ISFR = COLS_MASK;
+    keyAwake = 1;
+}
+#endif
+
+/****************************************************************************************
+* keyColsIn() - Waits for the row direction change to settle, then returns the columns.
+*             - The wait is timed with the DWT cycle counter so it follows the core clock
+*               in K65TWR_ClkCfg.h and does not depend on compiler optimization.
+*             - With KEY_SETTLE_SAMPLE_EN, after KEY_SETTLE_MIN_NS the columns are read
+*               until KEY_STABLE_READS reads in a row agree, up to KEY_SETTLE_NS. Otherwise
+*               it always waits KEY_SETTLE_NS.
+* (Private)
+****************************************************************************************/
+static INT8U keyColsIn(void){
+    INT32U start;
+    INT8U cols;
+#if KEY_SETTLE_SAMPLE_EN
+    INT8U last;
+    INT8U same = 0;
+#endif
+    start = DWT->CYCCNT;
+#if KEY_SETTLE_SAMPLE_EN
+    while((DWT->CYCCNT - start) < keySettleMinCyc){}
+    cols = (INT8U)COLS_IN();
+    while((same < KEY_STABLE_READS) && ((DWT->CYCCNT - start) < keySettleCyc)){
+        last = cols;
+        cols = (INT8U)COLS_IN();
+        if(cols == last){
+            same++;
+        }else{
+            same = 0;
+        }
+    }
+#else
+    while((DWT->CYCCNT - start) < keySettleCyc){}
+    cols = (INT8U)COLS_IN();
+#endif
+    return cols;
+}
+
+/*****************************************************************************************
+* KeyClkChange() - Clock change callback, see K65TWR_ClkRegister(). Converts the column
+*                  settle times to cycles of the new core clock.
+*****************************************************************************************/
+void KeyClkChange(INT32U core_hz, INT32U bus_hz){
+    keySettleCyc = KEY_NS_TO_CYC(core_hz, KEY_SETTLE_NS);
+    keySettleMinCyc = KEY_NS_TO_CYC(core_hz, KEY_SETTLE_MIN_NS);
 }
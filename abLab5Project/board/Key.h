@@ -7,6 +7,11 @@
 *            from B60 to A64 on the tower. Also, PORTA bit 6 must remain an unsued input.
 * 12/08/2015 Changed type for control codes.
 * 10/29/2018 Modified for MCUXpresso, Todd Morton
+* 10/18/2026 Added pin interrupt wake-up. PORTC_IRQHandler() is owned by Key.c.
+* 10/18/2026 Added key map, edge and ghosting functions for multi-key chords.
+* 10/18/2026 Added timestamped key event FIFO with long-press and auto-repeat.
+* 10/18/2026 Added KeyClkChange() clock change callback.
+* 10/18/2026 Added KeyIdle() and KeyWake() for low-leakage stop.
 ******************************************************************************************
 * Public Resources
 *****************************************************************************************/
@@ -22,13 +27,40 @@
 #define DC3 (INT8C)0x13     /*ASCII control code for the C button */
 #define DC4 (INT8C)0x14     /*ASCII control code for the D button */
 
+/*****************************************************************************************
+* Key events, see KeyGetEvent()
+*****************************************************************************************/
+typedef enum {KEY_EV_PRESS, KEY_EV_RELEASE, KEY_EV_LONG, KEY_EV_REPEAT} KEY_EV_TYPE;
+typedef struct{
+    INT8C code;             /* ASCII code of the key */
+    KEY_EV_TYPE type;
+    INT32U time;            /* SysTickGetmsCount() when detected */
+}KEY_EVENT;
 
 /*****************************************************************************************
-* KeyGet() - Returns current value of the keypad buffer then clears the buffer.
-*            The value returned is the ASCII code for the key pressed or zero if no key
-*            was pressed.
+* KEY_BIT(row,col) - Key map bit for a key, row and col range 1-4. For example the '*'
+*                    and '#' chord is (KEY_BIT(4,1)|KEY_BIT(4,3)).
+*****************************************************************************************/
+#define KEY_BIT(row,col) ((INT16U)(1U<<((((row)-1U)*4U)+((col)-1U))))
+
+
+/*****************************************************************************************
+* KeyGet() - Returns the ASCII code of the next queued press or repeat, or zero if no key
+*            was pressed. Other event types are discarded.
 *****************************************************************************************/
 INT8C KeyGet(void);
+
+/*****************************************************************************************
+* KeyGetEvent() - Removes the oldest key event into *event. Returns TRUE if there was one.
+*                 Call until it returns FALSE to drain all events of a slice.
+*****************************************************************************************/
+INT8U KeyGetEvent(KEY_EVENT *const event);
+
+/*****************************************************************************************
+* KeySetTiming() - Sets the hold time for a long-press event and the repeat period after
+*                  it, both in ms. Zero disables. Defaults are 1000ms and 200ms.
+*****************************************************************************************/
+void KeySetTiming(const INT16U long_ms, const INT16U repeat_ms);
                               
 /*****************************************************************************************
 * KeyInit() - Keypad Initialization. Must run before calling KeyTask.
@@ -39,7 +71,40 @@ void KeyInit(void);
 * KeyTask() - The main keypad scanning task. It scans the keypad and updates the keypad
 *             buffer if a keypress was verified. This is a cooperative task that must be
 *             called with a period between: Tb/2 < Tp < (Tact-Tb)/2
+*             While no key is pressed it does not scan, it waits for a column interrupt.
 *****************************************************************************************/
 void KeyTask(void);
 
+/*****************************************************************************************
+* KeyGetPressed() - Returns the debounced key map of all keys currently held.
+*****************************************************************************************/
+INT16U KeyGetPressed(void);
+
+/*****************************************************************************************
+* KeyGetPressEdges() - Returns a key map of keys pressed since the last call and clears it.
+* KeyGetReleaseEdges() - Same for released keys.
+*****************************************************************************************/
+INT16U KeyGetPressEdges(void);
+INT16U KeyGetReleaseEdges(void);
+
+/*****************************************************************************************
+* KeyGhosting() - Returns TRUE while the held keys can not be resolved by the matrix. The
+*                 key map does not change until they are released.
+*****************************************************************************************/
+INT8U KeyGhosting(void);
+
+/*****************************************************************************************
+* KeyClkChange() - Clock change callback for K65TWR_ClkRegister(). Rescales the column
+*                  settle delay to the new core clock.
+*****************************************************************************************/
+void KeyClkChange(INT32U core_hz, INT32U bus_hz);
+
+/*****************************************************************************************
+* KeyIdle() - Returns TRUE while no key is held and the rows are driven low waiting for a
+*             column edge. The column pins are then valid LLWU falling edge sources.
+* KeyWake() - Starts scanning after a wake-up from a column edge.
+*****************************************************************************************/
+INT8U KeyIdle(void);
+void KeyWake(void);
+
 #endif
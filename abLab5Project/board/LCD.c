@@ -10,11 +10,24 @@
 * Fixed LcdDispDecWord, Todd Morton, 12/13/2017
 * Modified for MCUXpresso, Todd Morton, 10/29/2018
 * Modified for MCUXpresso v11.2, added new LcdDispDecWord(), Todd Morton, 10/31/2020
+* Added shadow display buffer and LcdTask() dirty-cell flushing, 10/18/2026
+* Replaced busy-wait delays with a PIT1 paced operation queue, 10/18/2026
+* Added optional eDMA line streaming engine (LCD_DMA_EN), 10/18/2026
+* Number conversion moved to StrFmt.c, 10/18/2026
+* Added LcdPrintf(), 10/18/2026
+* Added CGRAM glyph cache, bar graph and icons, 10/18/2026
+* Tied all LCD delays to HD44780 datasheet minimums, added LcdGetBusTime(), 10/18/2026
+* PIT counts follow the bus clock, LcdClkChange(), 10/18/2026
+* Bus MHz rounded up so delays are never short at a fractional clock, 10/18/2026
+* lcdDly500ns() timed with the DWT cycle counter instead of an empty loop, 10/18/2026
+* Added LcdIdle(), clock changes wait for the running settle time, 10/18/2026
 ******************************************************************************************
 * Master Include File  
 *****************************************************************************************/
 #include "MCUType.h"
 #include "LCD.h"
+#include "StrFmt.h"
+#include "K65TWR_ClkCfg.h"
 
 /*****************************************************************************************
 * LCD Port Defines 
@@ -44,37 +57,300 @@
 #define LCD_BS_CMD     0x10   /* Move cursor left one space */
 #define LCD_FS_CMD     0x14   /* Move cursor right one space */
 
+#define NUM_ROWS       2      /* 2 line display */
+
+/*****************************************************************************************
+* LCD Operation Queue
+*   Every bus transfer is queued as a 16-bit operation and sent by PIT1_IRQHandler(). After
+*   each operation the PIT is loaded with that operation's settle time so the next one is
+*   not sent until the LCD is ready. Only the sub-microsecond E pulse timing is still done
+*   with lcdDly500ns(), inside the ISR.
+*   Operation format: [15:12] type, [11:8] delay code, [7:0] byte
+*****************************************************************************************/
+#define LCD_OPQ_SIZE   64U                    /* Must be a power of two */
+#define LCD_OPQ_MASK   (LCD_OPQ_SIZE - 1U)
+
+#define LCD_OP_WAIT    0x0U   /* No transfer, delay only */
+#define LCD_OP_NIB     0x1U   /* Single nibble command, used for RESET sequence */
+#define LCD_OP_CMD     0x2U   /* Command byte, RS = 0 */
+#define LCD_OP_DATA    0x3U   /* Data byte, RS = 1 */
+
+#define LCD_DLY_40US   0x0U   /* Delay codes, index into lcdDlyUs[] */
+#define LCD_DLY_100US  0x1U
+#define LCD_DLY_2MS    0x2U
+#define LCD_DLY_5MS    0x3U
+#define LCD_DLY_15MS   0x4U
+
+#define LCD_OP(type,dly,byte) ((INT16U)(((type)<<12)|((dly)<<8)|(byte)))
+#define LCD_OP_TYPE(op)       ((INT8U)((op)>>12))
+#define LCD_OP_DLY(op)        ((INT8U)(((op)>>8) & 0x0FU))
+#define LCD_OP_BYTE(op)       ((INT8U)((op) & 0xFFU))
+
+#define LCD_PIT_CH        1U          /* PIT0 is used by AlarmWave */
+#define LCD_BUS_CLK_MHZ   (K65TWR_BUS_CLK_HZ/1000000U)   /* PIT clock at boot */
+#define LCD_PIT_CNT(us)   (((us)*lcdBusMHz) - 1U)
+static INT32U lcdBusMHz = LCD_BUS_CLK_MHZ;      /* Set by LcdClkChange() */
+#define LCD_PIT_PRIORITY  2U          /* Below the alarm wave sample interrupt */
+
+/*****************************************************************************************
+* HD44780 Timing
+*   Minimums from the Hitachi HD44780U datasheet (fosc = 270kHz, VCC = 4.5-5.5V). Every
+*   delay this module uses is defined below with a check against its minimum, so a delay
+*   can be shortened for speed without the risk of silently violating the panel timing.
+*****************************************************************************************/
+#define LCD_T_PWEH_NS     230U      /* E pulse width high */
+#define LCD_T_CYCE_NS     500U      /* E cycle time, so E low >= tcycE - PWEH */
+#define LCD_T_EXEC_US     37U       /* Execution time of all but clear and home */
+#define LCD_T_CLEAR_US    1520U     /* Clear display and return home */
+#define LCD_T_POWER_US    15000U    /* VCC rising to 4.5V before the first nibble */
+#define LCD_T_RESET1_US   4100U     /* After the first function set nibble */
+#define LCD_T_RESET2_US   100U      /* After the second function set nibble */
+
+#define LCD_SETTLE_EXEC_US    40U
+#define LCD_SETTLE_RESET2_US  100U
+#define LCD_SETTLE_CLEAR_US   2000U
+#define LCD_SETTLE_RESET1_US  5000U
+#define LCD_SETTLE_POWER_US   15000U
+
+#if (LCD_SETTLE_EXEC_US < LCD_T_EXEC_US) || (LCD_SETTLE_CLEAR_US < LCD_T_CLEAR_US) || \
+    (LCD_SETTLE_POWER_US < LCD_T_POWER_US) || (LCD_SETTLE_RESET1_US < LCD_T_RESET1_US) || \
+    (LCD_SETTLE_RESET2_US < LCD_T_RESET2_US)
+#error LCD settle time is shorter than the HD44780 minimum
+#endif
+
+/* lcdDly500ns() waits lcdDlyCyc core cycles on the DWT cycle counter, so it does not
+ * depend on compiler optimization. The count is rounded up from LCD_DLY500NS_NS and
+ * LcdClkChange() recomputes it for the new core clock. The checks are on the count
+ * at the boot clock.                                                                 */
+#define LCD_CORE_CLK_MHZ      ((K65TWR_CORE_CLK_HZ + 999999U)/1000000U)
+#define LCD_NS_TO_CYC(hz,ns)  (((((hz) + 999999U)/1000000U)*(ns) + 999U)/1000U)
+#define LCD_DLY500NS_NS       500U
+#define LCD_DLY500NS_CYC      LCD_NS_TO_CYC(K65TWR_CORE_CLK_HZ, LCD_DLY500NS_NS)
+#define LCD_DLY500NS_MIN_NS   ((LCD_DLY500NS_CYC*1000U)/LCD_CORE_CLK_MHZ)
+static INT32U lcdDlyCyc = LCD_DLY500NS_CYC;     /* Set by LcdClkChange() */
+
+#if LCD_DLY500NS_MIN_NS < LCD_T_PWEH_NS
+#error lcdDly500ns() is shorter than the HD44780 E pulse width
+#endif
+#if (2U*LCD_DLY500NS_MIN_NS) < (LCD_T_CYCE_NS - LCD_T_PWEH_NS)
+#error E low time between nibbles is shorter than the HD44780 E cycle
+#endif
+
+static const INT16U lcdDlyUs[] = {
+    LCD_SETTLE_EXEC_US,         /* Most commands and data writes */
+    LCD_SETTLE_RESET2_US,       /* RESET sequence, second nibble */
+    LCD_SETTLE_CLEAR_US,        /* Clear display */
+    LCD_SETTLE_RESET1_US,       /* RESET sequence, first nibble */
+    LCD_SETTLE_POWER_US         /* Power up */
+};
+
+static volatile INT32U lcdBusTimeUs;  /* Bus time used since LcdDispInit() */
+
+/*****************************************************************************************
+* eDMA Line Engine
+*   When LCD_DMA_EN is 1, LcdTask() compiles the dirty span of a line (set-address command
+*   plus characters) into a table of GPIOD->PDOR words with the RS, nibble and E phases
+*   already laid out. PIT2 triggers DMA channel 2 once per LCD_WAVE_TICK_US to clock one
+*   word out to the port, so the CPU does nothing during the transfer.
+*   Note: PDOR is written as a whole port, so PORTD bits other than the LCD keep the value
+*   they had when the table was compiled. They must not be driven by other modules.
+*   The operation queue is held off while a DMA transfer is running and vice versa.
+*****************************************************************************************/
+#define LCD_DMA_EN         0U
+#if LCD_DMA_EN
+#define LCD_DMA_CH         2U       /* PIT2 triggers DMA channel 2 */
+#define LCD_DMA_SRC        60U      /* DMAMUX always enabled slot */
+#define LCD_WAVE_TICK_US   10U
+#define LCD_WAVE_SETTLE    4U       /* Ticks after the last E fall, >37us */
+#define LCD_WAVE_PER_BYTE  (4U + LCD_WAVE_SETTLE)
+#define LCD_WAVE_SIZE      ((NUM_CHARS + 1U)*LCD_WAVE_PER_BYTE)
+#if (LCD_WAVE_SETTLE*LCD_WAVE_TICK_US) < LCD_T_EXEC_US
+#error LCD DMA settle time is shorter than the HD44780 execution time
+#endif
+
+static INT32U lcdWave[LCD_WAVE_SIZE];
+static INT32U lcdWaveBase;            /* PDOR with all LCD bits cleared */
+static volatile INT8U lcdDmaBusy;
+static INT16U lcdWaveByte(INT16U idx, const INT32U rs, const INT8U byte);
+static void lcdDmaStart(const INT16U nwords);
+void DMA2_DMA18_IRQHandler(void);
+#endif
+
+static INT16U lcdOpQueue[LCD_OPQ_SIZE];
+static volatile INT8U lcdOpHead;      /* Written only by the producer (tasks) */
+static volatile INT8U lcdOpTail;      /* Written only by PIT1_IRQHandler() */
+static volatile INT8U lcdOpBusy;      /* PIT is running an operation or its delay */
+
+/*****************************************************************************************
+* Shadow display buffer
+*   lcdShadow[][] holds what the application wants on the display. lcdPanel[][] holds
+*   what has actually been written to the panel. LcdTask() sends only the cells that
+*   differ. lcdPanelAddr tracks the panel's DDRAM address counter (as a set-address
+*   command) so consecutive dirty cells do not need a cursor move between them.
+*****************************************************************************************/
+static INT8C lcdShadow[NUM_ROWS][NUM_CHARS];
+static INT8C lcdPanel[NUM_ROWS][NUM_CHARS];
+static INT8U lcdCurRow;
+static INT8U lcdCurCol;
+static INT8U lcdPanelAddr;
+static INT8U lcdCursorOn;
+
 /*****************************************************************************************
+* CGRAM Glyph Cache
+*   The eight CGRAM slots are managed as an LRU cache keyed by the address of a constant
+*   8-byte pattern. A pattern is only uploaded when it is not already resident. Slots whose
+*   code is on the panel or in the shadow buffer are not evicted unless every slot is.
+*   Glyphs are displayed with codes 0x08-0x0F, which the HD44780 maps to the same CGRAM
+*   slots as 0x00-0x07, so glyphs can be used in NULL terminated strings.
+*****************************************************************************************/
+#define LCD_NUM_GLYPHS    8U
+#define LCD_GLYPH_ROWS    8U
+#define LCD_GLYPH_CODE    0x08U     /* Display code for slot 0 */
+#define LCD_CGRAM_ADDR    0x40U     /* Set CGRAM address command */
+#define LCD_ADDR_UNKNOWN  0x00U     /* Panel address counter is in CGRAM */
+#define LCD_FULL_BLOCK    ((INT8C)0xFF)   /* Full 5x8 block in the character ROM */
+#define LCD_BAR_COLS      5U        /* Pixel columns per character */
+
+static const INT8U *lcdGlyphPat[LCD_NUM_GLYPHS];
+static INT32U lcdGlyphUsed[LCD_NUM_GLYPHS];     /* lcdGlyphClock at last use */
+static INT32U lcdGlyphClock;
+
+static const INT8U lcdBarGlyphs[LCD_BAR_COLS - 1U][LCD_GLYPH_ROWS] = {
+    {0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x00},  /* 1 column  */
+    {0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x00},  /* 2 columns */
+    {0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x00},  /* 3 columns */
+    {0x1E,0x1E,0x1E,0x1E,0x1E,0x1E,0x1E,0x00}   /* 4 columns */
+};
+
+static const INT8U lcdIconGlyphs[][LCD_GLYPH_ROWS] = {
+    {0x0E,0x11,0x11,0x1F,0x1B,0x1B,0x1F,0x00},  /* LCD_ICON_LOCK   */
+    {0x0E,0x10,0x10,0x1F,0x1B,0x1B,0x1F,0x00},  /* LCD_ICON_UNLOCK */
+    {0x04,0x0E,0x0E,0x0E,0x1F,0x00,0x04,0x00}   /* LCD_ICON_BELL   */
+};
+
+/*****************************************************************************************
 * Private Function prototypes
 *****************************************************************************************/
 static void lcdWrCmd(const INT8U cmd);
 static void lcdDly500ns(void);
-static void lcdDly40us(void);
-static void lcdDlyms(const INT8U ms);
 static void lcdWrNib(INT8U nib);
-static INT8C lcdHtoA(INT8U hnib);
+static void lcdWrData(const INT8C c);
+static void lcdWrByte(const INT8U byte);
+static void lcdOpPut(const INT16U op);
+static INT8U lcdOpSpace(void);
+static INT8U lcdCellAddr(const INT8U row, const INT8U col);
+static INT8U lcdGlyphOnDisplay(const INT8C code);
+
+/*****************************************************************************************
+* Handler must not be static so linker can see it.
+*****************************************************************************************/
+void PIT1_IRQHandler(void);
 
 /*****************************************************************************************
 * Function Definitions
 ******************************************************************************************
 * lcdWrCmd(INT8U cmd) - Private
 *  PARAMETERS: cmd - Command to be sent to the LCD
-*  DESCRIPTION: Sends a command write sequence to the LCD
+*  DESCRIPTION: Queues a command write to the LCD
 *****************************************************************************************/
 static void lcdWrCmd(const INT8U cmd) {
-      LCD_CLR_RS();                 //Select command
-      lcdWrNib(cmd>>4);             //Out most sig nibble
+    if(cmd == LCD_CLR_CMD){
+        lcdOpPut(LCD_OP(LCD_OP_CMD, LCD_DLY_2MS, cmd));
+    }else{
+        lcdOpPut(LCD_OP(LCD_OP_CMD, LCD_DLY_40US, cmd));
+    }
+}
+
+/*****************************************************************************************
+* lcdWrByte(INT8U byte) - Private
+*  PARAMETERS: byte - Byte to be sent to the LCD. RS must already be set.
+*  DESCRIPTION: Sends both nibbles of a byte. Called only from PIT1_IRQHandler().
+*****************************************************************************************/
+static void lcdWrByte(const INT8U byte) {
+      lcdWrNib(byte>>4);            //Out most sig nibble
       LCD_SET_E();                  //Pulse E. 230ns min per Seiko doc
       lcdDly500ns();
       LCD_CLR_E();
       lcdDly500ns();                //Wait >1us per Seiko doc
       lcdDly500ns();
-      lcdWrNib((cmd & 0x0fu));      //Out least sig nibble
+      lcdWrNib((byte & 0x0fu));     //Out least sig nibble
       LCD_SET_E();                  //Pulse E
       lcdDly500ns();
       LCD_CLR_E();
-      lcdDly40us();                 //Wait 40us per Seiko doc
-      LCD_SET_RS();                 //Set back to data
+}
+
+/*****************************************************************************************
+* lcdOpPut(INT16U op) - Private
+*  PARAMETERS: op - Operation to be queued
+*  DESCRIPTION: Adds an operation to the queue and starts the PIT if it is idle. If the
+*               queue is full it waits for the ISR to make room. LcdTask() checks
+*               lcdOpSpace() first so only init and cursor mode changes can wait.
+*               Single producer, single consumer so no critical section is needed: the ISR
+*               only clears lcdOpBusy after it sees an empty queue.
+*****************************************************************************************/
+static void lcdOpPut(const INT16U op) {
+    while(lcdOpSpace() == 0){}
+    lcdOpQueue[lcdOpHead] = op;
+    lcdOpHead = (INT8U)((lcdOpHead + 1U) & LCD_OPQ_MASK);
+    if(lcdOpBusy == 0){
+        lcdOpBusy = 1;
+        NVIC_SetPendingIRQ(PIT1_IRQn);
+    }else{
+    }
+}
+
+/*****************************************************************************************
+* lcdOpSpace() - Private
+*  DESCRIPTION: Returns the number of free operation queue slots.
+*****************************************************************************************/
+static INT8U lcdOpSpace(void) {
+    return (INT8U)((LCD_OPQ_SIZE - 1U) - ((lcdOpHead - lcdOpTail) & LCD_OPQ_MASK));
+}
+
+/*****************************************************************************************
+* PIT1_IRQHandler() - Sends the next queued operation then loads the PIT with its settle
+*                     time. The PIT is stopped when the queue is empty and the last
+*                     operation's settle time has passed.
+*****************************************************************************************/
+void PIT1_IRQHandler(void){
+    INT16U op;
+    PIT->CHANNEL[LCD_PIT_CH].TFLG = PIT_TFLG_TIF(1);
+    PIT->CHANNEL[LCD_PIT_CH].TCTRL = 0;             /* Stop so new LDVAL loads on restart */
+#if LCD_DMA_EN
+    if(lcdDmaBusy != 0){                            /* Port in use by DMA, try again later */
+        PIT->CHANNEL[LCD_PIT_CH].LDVAL = LCD_PIT_CNT(LCD_SETTLE_EXEC_US);
+        PIT->CHANNEL[LCD_PIT_CH].TCTRL = (PIT_TCTRL_TIE(1)|PIT_TCTRL_TEN(1));
+    }else if(lcdOpTail != lcdOpHead){
+#else
+    if(lcdOpTail != lcdOpHead){
+#endif
+        op = lcdOpQueue[lcdOpTail];
+        lcdOpTail = (INT8U)((lcdOpTail + 1U) & LCD_OPQ_MASK);
+        switch(LCD_OP_TYPE(op)){
+        case LCD_OP_NIB:
+            LCD_CLR_RS();
+            lcdWrNib(LCD_OP_BYTE(op));
+            LCD_SET_E();
+            lcdDly500ns();
+            LCD_CLR_E();
+            break;
+        case LCD_OP_CMD:
+            LCD_CLR_RS();
+            lcdWrByte(LCD_OP_BYTE(op));
+            break;
+        case LCD_OP_DATA:
+            LCD_SET_RS();
+            lcdWrByte(LCD_OP_BYTE(op));
+            break;
+        default:                                    /* LCD_OP_WAIT */
+            break;
+        }
+        PIT->CHANNEL[LCD_PIT_CH].LDVAL = LCD_PIT_CNT((INT32U)lcdDlyUs[LCD_OP_DLY(op)]);
+        lcdBusTimeUs += lcdDlyUs[LCD_OP_DLY(op)];
+        PIT->CHANNEL[LCD_PIT_CH].TCTRL = (PIT_TCTRL_TIE(1)|PIT_TCTRL_TEN(1));
+    }else{
+        lcdOpBusy = 0;
+    }
 }
 
 /*****************************************************************************************
@@ -94,6 +370,8 @@ static void lcdWrNib(INT8U nib){
 *               Data sheet. In this case, 4-bit mode.
 *****************************************************************************************/
 void LcdDispInit(void) {
+    INT8U row;
+    INT8U col;
     SIM->SCGC5 |= SIM_SCGC5_PORTD(1);
 	PORTD->PCR[1] = PORT_PCR_MUX(1);
 	PORTD->PCR[2] = PORT_PCR_MUX(1);
@@ -102,39 +380,58 @@ void LcdDispInit(void) {
 	PORTD->PCR[5] = PORT_PCR_MUX(1);
 	PORTD->PCR[6] = PORT_PCR_MUX(1);
 	INIT_BIT_DIR();
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;     /* DWT cycle counter on */
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
     LCD_CLR_E(); 
-    LCD_SET_RS();               /*Data select unless in lcdWrCmd()  */
-    lcdDlyms(15);               /* LCD requires 15ms delay at powerup */
-   
-    LCD_CLR_RS();               /*Send first command for RESET sequence*/
-    lcdWrNib(0x3u);
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyms(5);                /*Wait >4.1ms */
-  
-    lcdWrNib(0x3u);             /*Repeat */
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDlyms(1);                /*Wait >100us */
-  
-    lcdWrNib(0x3u);             /* Repeat */
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDly40us();               /*Wait >40us*/
-  
-    lcdWrNib(0x2u);             /*Send last command for RESET sequence*/
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDly40us();
+    LCD_SET_RS();
+
+    SIM->SCGC6 |= SIM_SCGC6_PIT(1);             /* PIT paces the operation queue */
+    PIT->MCR = PIT_MCR_MDIS(0);
+    PIT->CHANNEL[LCD_PIT_CH].TCTRL = 0;
+    lcdOpHead = 0;
+    lcdOpTail = 0;
+    lcdOpBusy = 0;
+    lcdBusTimeUs = 0;
+    NVIC_SetPriority(PIT1_IRQn, LCD_PIT_PRIORITY);
+    NVIC_EnableIRQ(PIT1_IRQn);
+#if LCD_DMA_EN
+    SIM->SCGC6 |= SIM_SCGC6_DMAMUX(1);
+    SIM->SCGC7 |= SIM_SCGC7_DMA(1);
+    lcdDmaBusy = 0;
+    PIT->CHANNEL[LCD_DMA_CH].TCTRL = 0;
+    PIT->CHANNEL[LCD_DMA_CH].LDVAL = LCD_PIT_CNT(LCD_WAVE_TICK_US);
+    DMAMUX->CHCFG[LCD_DMA_CH] = 0;
+    DMAMUX->CHCFG[LCD_DMA_CH] = (DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|
+                                 DMAMUX_CHCFG_SOURCE(LCD_DMA_SRC));
+    NVIC_SetPriority(DMA2_DMA18_IRQn, LCD_PIT_PRIORITY);
+    NVIC_EnableIRQ(DMA2_DMA18_IRQn);
+#endif
+
+    lcdOpPut(LCD_OP(LCD_OP_WAIT, LCD_DLY_15MS, 0x0U));  /* 15ms delay at powerup */
+    lcdOpPut(LCD_OP(LCD_OP_NIB, LCD_DLY_5MS, 0x3U));    /* RESET sequence, wait >4.1ms */
+    lcdOpPut(LCD_OP(LCD_OP_NIB, LCD_DLY_100US, 0x3U));  /* Repeat, wait >100us */
+    lcdOpPut(LCD_OP(LCD_OP_NIB, LCD_DLY_40US, 0x3U));   /* Repeat, wait >40us */
+    lcdOpPut(LCD_OP(LCD_OP_NIB, LCD_DLY_40US, 0x2U));   /* Last command for RESET */
   
     lcdWrCmd(LCD_DAT_INIT);     /*Send command for 4-bit mode */
     lcdWrCmd(LCD_SHIFT_CUR);
     lcdWrCmd(LCD_DIS_INIT);
-    LcdDispClear();
+    lcdWrCmd(LCD_CLR_CMD);
+    for(row = 0; row < NUM_ROWS; row++){     /* Panel and shadow are both blank */
+        for(col = 0; col < NUM_CHARS; col++){
+            lcdShadow[row][col] = ' ';
+            lcdPanel[row][col] = ' ';
+        }
+    }
+    for(col = 0; col < LCD_NUM_GLYPHS; col++){
+        lcdGlyphPat[col] = (const INT8U *)0;
+        lcdGlyphUsed[col] = 0;
+    }
+    lcdGlyphClock = 0;
+    lcdPanelAddr = LCD_LINE1_ADDR;
+    lcdCurRow = 0;
+    lcdCurCol = 0;
+    lcdCursorOn = FALSE;
 } 
 
 /*****************************************************************************************
@@ -142,32 +439,190 @@ void LcdDispInit(void) {
 *
 *  PARAMETERS: c - ASCII character to be sent to the LCD
 *
-*  DESCRIPTION: Displays a character at current LCD address. Assumes that the LCD port is
-*               configured for a data write.
+*  DESCRIPTION: Places a character in the shadow buffer at the current cursor location and
+*               advances the cursor. Characters past column 16 are dropped. The panel is
+*               updated by LcdTask().
 *****************************************************************************************/
 void LcdDispChar(const INT8C c) {
-    lcdWrNib(((INT8U)c >> 4));
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDly500ns();
-    lcdDly500ns();
-    lcdWrNib(((INT8U)c & 0x0fu));
-    LCD_SET_E();
-    lcdDly500ns();
-    LCD_CLR_E();
-    lcdDly40us();
+    if(lcdCurCol < NUM_CHARS){
+        lcdShadow[lcdCurRow][lcdCurCol] = c;
+        lcdCurCol++;
+    }else{
+        /* Past end of line, not visible */
+    }
+}
+
+/*****************************************************************************************
+** lcdWrData() - Private
+*  PARAMETERS: c - character to be written to the LCD at the panel address counter.
+*  DESCRIPTION: Queues a data write to the LCD.
+*****************************************************************************************/
+static void lcdWrData(const INT8C c) {
+    lcdOpPut(LCD_OP(LCD_OP_DATA, LCD_DLY_40US, (INT8U)c));
 }
 
 /*****************************************************************************************
+** LcdTask() - Public
+*  DESCRIPTION: Cooperative task that brings the panel up to date with the shadow buffer.
+*               Only cells that changed are written and a set-address command is only sent
+*               when the next dirty cell is not where the panel address counter already is.
+*               If the cursor is on, the panel cursor is returned to the shadow cursor.
+*               Stops when the operation queue is full; the rest is sent next time.
+*****************************************************************************************/
+void LcdTask(void) {
+    INT8U row = 0;
+    INT8U col = 0;
+    INT8U addr;
+#if LCD_DMA_EN
+    INT8U last;
+    INT16U nwords;
+
+    if((lcdDmaBusy == 0) && (lcdOpBusy == 0)){
+        while(row < NUM_ROWS){                      /* One line per DMA transfer */
+            col = 0;
+            while((col < NUM_CHARS) && (lcdShadow[row][col] == lcdPanel[row][col])){
+                col++;
+            }
+            if(col < NUM_CHARS){
+                last = NUM_CHARS - 1U;
+                while(lcdShadow[row][last] == lcdPanel[row][last]){
+                    last--;
+                }
+                lcdWaveBase = GPIOD->PDOR & (INT32U)~(LCD_RS_BIT|LCD_E_BIT|LCD_DB_MASK);
+                nwords = 0;
+                addr = lcdCellAddr(row, col);
+                if(lcdPanelAddr != addr){
+                    nwords = lcdWaveByte(nwords, 0U, addr);
+                }else{
+                }
+                while(col <= last){                 /* Clean cells in the span are resent */
+                    nwords = lcdWaveByte(nwords, LCD_RS_BIT, (INT8U)lcdShadow[row][col]);
+                    lcdPanel[row][col] = lcdShadow[row][col];
+                    col++;
+                }
+                lcdPanelAddr = lcdCellAddr(row, col);
+                lcdDmaStart(nwords);
+                row = NUM_ROWS;
+            }else{
+                row++;
+            }
+        }
+    }else{
+    }
+#else
+    while((row < NUM_ROWS) && (lcdOpSpace() >= 2U)){   /* Room for address and data */
+        if(lcdShadow[row][col] != lcdPanel[row][col]){
+            addr = lcdCellAddr(row, col);
+            if(lcdPanelAddr != addr){
+                lcdWrCmd(addr);
+            }else{
+            }
+            lcdWrData(lcdShadow[row][col]);
+            lcdPanel[row][col] = lcdShadow[row][col];
+            lcdPanelAddr = (INT8U)(addr + 1);
+        }else{
+        }
+        col++;
+        if(col >= NUM_CHARS){
+            col = 0;
+            row++;
+        }else{
+        }
+    }
+#endif
+    if(lcdCursorOn != FALSE){
+        addr = lcdCellAddr(lcdCurRow, lcdCurCol);
+        if((lcdPanelAddr != addr) && (lcdOpSpace() > 0)){
+            lcdWrCmd(addr);
+            lcdPanelAddr = addr;
+        }else{
+        }
+    }else{
+    }
+}
+
+#if LCD_DMA_EN
+/*****************************************************************************************
+** lcdWaveByte() - Private
+*  PARAMETERS: idx - next free word in lcdWave[], rs - LCD_RS_BIT for data or 0 for a
+*              command, byte - byte to be sent.
+*  DESCRIPTION: Compiles one byte into port words. RS is set up one tick before E rises
+*               and each nibble is latched on the falling edge of E. The settle ticks keep
+*               the last nibble on the port. Returns the next free word.
+*****************************************************************************************/
+static INT16U lcdWaveByte(INT16U idx, const INT32U rs, const INT8U byte) {
+    INT8U i;
+    INT32U hi = lcdWaveBase | rs | ((INT32U)(byte >> 4) << 3);
+    INT32U lo = lcdWaveBase | rs | ((INT32U)(byte & 0x0fu) << 3);
+
+    lcdWave[idx++] = hi;
+    lcdWave[idx++] = hi | LCD_E_BIT;
+    lcdWave[idx++] = hi;                        /* Latch most sig nibble */
+    lcdWave[idx++] = lo | LCD_E_BIT;
+    for(i = 0; i < LCD_WAVE_SETTLE; i++){
+        lcdWave[idx++] = lo;                    /* Latch least sig nibble and settle */
+    }
+    return idx;
+}
+
+/*****************************************************************************************
+** lcdDmaStart() - Private
+*  PARAMETERS: nwords - number of words in lcdWave[] to send.
+*  DESCRIPTION: Sets up the DMA channel to copy lcdWave[] to GPIOD->PDOR, one 32-bit word
+*               per PIT2 trigger, and starts PIT2.
+*****************************************************************************************/
+static void lcdDmaStart(const INT16U nwords) {
+    lcdDmaBusy = 1;
+    lcdBusTimeUs += (INT32U)nwords*LCD_WAVE_TICK_US;
+    DMA0->TCD[LCD_DMA_CH].SADDR = DMA_SADDR_SADDR((INT32U)&lcdWave[0]);
+    DMA0->TCD[LCD_DMA_CH].SOFF = DMA_SOFF_SOFF(4U);
+    DMA0->TCD[LCD_DMA_CH].ATTR = (DMA_ATTR_SSIZE(2U)|DMA_ATTR_DSIZE(2U));
+    DMA0->TCD[LCD_DMA_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(4U);
+    DMA0->TCD[LCD_DMA_CH].SLAST = DMA_SLAST_SLAST(-(INT32S)(nwords*4U));
+    DMA0->TCD[LCD_DMA_CH].DADDR = DMA_DADDR_DADDR((INT32U)&GPIOD->PDOR);
+    DMA0->TCD[LCD_DMA_CH].DOFF = DMA_DOFF_DOFF(0U);
+    DMA0->TCD[LCD_DMA_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(nwords);
+    DMA0->TCD[LCD_DMA_CH].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(nwords);
+    DMA0->TCD[LCD_DMA_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0U);
+    DMA0->TCD[LCD_DMA_CH].CSR = (DMA_CSR_DREQ(1)|DMA_CSR_INTMAJOR(1));
+    DMA0->SERQ = DMA_SERQ_SERQ(LCD_DMA_CH);
+    PIT->CHANNEL[LCD_DMA_CH].TCTRL = PIT_TCTRL_TEN(1);
+}
+
+/*****************************************************************************************
+* DMA2_DMA18_IRQHandler() - Line transfer complete. Stops the PIT trigger and releases the
+*                           port to the operation queue.
+*****************************************************************************************/
+void DMA2_DMA18_IRQHandler(void){
+    DMA0->CINT = DMA_CINT_CINT(LCD_DMA_CH);
+    PIT->CHANNEL[LCD_DMA_CH].TCTRL = 0;
+    lcdDmaBusy = 0;
+}
+#endif
+
+/*****************************************************************************************
+** lcdCellAddr() - Private
+*  PARAMETERS: row - shadow row (0 or 1), col - shadow column (0 - 16).
+*  DESCRIPTION: Returns the set DDRAM address command for a cell.
+*****************************************************************************************/
+static INT8U lcdCellAddr(const INT8U row, const INT8U col) {
+    INT8U addr;
+    if(row == 0){
+        addr = (INT8U)(LCD_LINE1_ADDR + col);
+    }else{
+        addr = (INT8U)(LCD_LINE2_ADDR + col);
+    }
+    return addr;
+}
+
+/*****************************************************************************************
 ** LcdDispClear
 *  PARAMETERS: None
 *  DESCRIPTION: Clears the LCD display and returns the cursor to row1, col1.
 *****************************************************************************************/
 void LcdDispClear(void) {
-
-    lcdWrCmd(LCD_CLR_CMD);
-    lcdDlyms(2);
+    LcdDispLineClear(2);
+    LcdDispLineClear(1);
 }
 
 /*****************************************************************************************
@@ -177,24 +632,15 @@ void LcdDispClear(void) {
 *               column 1 of that line.
 *****************************************************************************************/
 void LcdDispLineClear(const INT8U line) {
-  
-   INT8U start_addr; 
+
    INT8U i;
 
-   if(line == 1){ 
-      start_addr = LCD_LINE1_ADDR;  
-      lcdWrCmd(start_addr);
-      for(i = 0x0; i < (NUM_CHARS); i++) {
-         LcdDispChar(' ');
-      }
-      lcdWrCmd(start_addr);
-   }else if(line == 2){ 
-      start_addr = LCD_LINE2_ADDR;
-      lcdWrCmd(start_addr);
+   if((line == 1) || (line == 2)){
+      lcdCurRow = (INT8U)(line - 1);
       for(i = 0x0; i < (NUM_CHARS); i++) {
-         LcdDispChar(' ');
+         lcdShadow[lcdCurRow][i] = ' ';
       }
-      lcdWrCmd(start_addr);
+      lcdCurCol = 0;
    }else{
       /* Input error, do nothing */
    }
@@ -207,18 +653,12 @@ void LcdDispLineClear(const INT8U line) {
 *  DESCRIPTION: Displays word, in hex.
 *****************************************************************************************/
 void LcdDispHexWord(const INT32U word, const INT8U num_nib) {
-    INT8U currentnib;
-    // Limit number of nibbles
-    if((num_nib > 0) && (num_nib <= 8)){
-        currentnib = num_nib;
-        while(currentnib > 0){
-            LcdDispChar(lcdHtoA((word>>((currentnib-1)*4))&0x0F));
-            currentnib--;
-        }
+    INT8C hexstrg[9];
+    if(FmtHexWord(hexstrg, word, num_nib) > 0){
+        LcdDispString(hexstrg);
     }else{
         LcdDispString("HexNibError");
     }
-
 }
 /*****************************************************************************************
 * LcdDispString()
@@ -235,6 +675,177 @@ void LcdDispString(INT8C *const strg) {
     }
 }
 
+/*****************************************************************************************
+* LcdGetBusTime()
+*  RETURN VALUE: LCD bus time in microseconds since LcdDispInit(), wraps at 2^32.
+*  DESCRIPTION: Each transfer adds the settle time it holds the bus for. Taking the
+*               difference around an LcdTask() call gives the bus time of that update.
+*****************************************************************************************/
+INT32U LcdGetBusTime(void) {
+    return lcdBusTimeUs;
+}
+
+/*****************************************************************************************
+* LcdIdle()
+*  RETURN VALUE: TRUE when the operation queue is empty and the last settle time is over,
+*                FALSE while the PIT (or the DMA engine) still has the bus.
+*  DESCRIPTION: A running PIT count is not rescaled by LcdClkChange(), so a bus clock
+*               change must wait for this. Otherwise going from 16MHz to 60MHz would end
+*               the settle time 3.75 times early.
+*****************************************************************************************/
+INT8U LcdIdle(void) {
+    INT8U idle = TRUE;
+    if(lcdOpBusy != 0){
+        idle = FALSE;
+    }else{
+    }
+#if LCD_DMA_EN
+    if(lcdDmaBusy != 0){
+        idle = FALSE;
+    }else{
+    }
+#endif
+    return idle;
+}
+
+/*****************************************************************************************
+* LcdGlyph()
+*  PARAMETERS: pattern - pointer to a constant 8-byte glyph, one byte per pixel row, 5 LSBs.
+*  DESCRIPTION: Returns the display code for pattern, uploading it to CGRAM only if it is
+*               not already resident. The victim is a free slot, else the least recently
+*               used slot that is not displayed, else the least recently used slot.
+*****************************************************************************************/
+INT8C LcdGlyph(const INT8U *const pattern) {
+    INT8U slot;
+    INT8U victim = LCD_NUM_GLYPHS;
+    INT8U lru = 0;
+    INT8U undisplayed = FALSE;         /* lru is a slot not on the display */
+    INT8U row;
+
+    lcdGlyphClock++;
+    for(slot = 0; slot < LCD_NUM_GLYPHS; slot++){
+        if(lcdGlyphPat[slot] == pattern){
+            victim = slot;                          /* Resident, no upload */
+        }else{
+        }
+    }
+    if(victim == LCD_NUM_GLYPHS){
+        for(slot = 0; slot < LCD_NUM_GLYPHS; slot++){
+            if((victim == LCD_NUM_GLYPHS) && (lcdGlyphPat[slot] == (const INT8U *)0)){
+                victim = slot;                      /* First free slot */
+            }else{
+            }
+        }
+        for(slot = 0; (slot < LCD_NUM_GLYPHS) && (victim == LCD_NUM_GLYPHS); slot++){
+            if(((undisplayed == FALSE) || (lcdGlyphUsed[slot] < lcdGlyphUsed[lru])) &&
+               (lcdGlyphOnDisplay((INT8C)(LCD_GLYPH_CODE + slot)) == FALSE)){
+                lru = slot;                         /* LRU slot not displayed */
+                undisplayed = TRUE;
+            }else{
+            }
+        }
+        if(victim == LCD_NUM_GLYPHS){
+            if(undisplayed == FALSE){               /* All displayed, evict LRU anyway */
+                for(slot = 0; slot < LCD_NUM_GLYPHS; slot++){
+                    if(lcdGlyphUsed[slot] < lcdGlyphUsed[lru]){
+                        lru = slot;
+                    }else{
+                    }
+                }
+            }else{
+            }
+            victim = lru;
+        }else{
+        }
+        lcdGlyphPat[victim] = pattern;
+        lcdWrCmd((INT8U)(LCD_CGRAM_ADDR + (victim*LCD_GLYPH_ROWS)));
+        for(row = 0; row < LCD_GLYPH_ROWS; row++){
+            lcdWrData((INT8C)pattern[row]);
+        }
+        lcdPanelAddr = LCD_ADDR_UNKNOWN;            /* LcdTask() must set DDRAM address */
+    }else{
+    }
+    lcdGlyphUsed[victim] = lcdGlyphClock;
+    return (INT8C)(LCD_GLYPH_CODE + victim);
+}
+
+/*****************************************************************************************
+** lcdGlyphOnDisplay() - Private
+*  PARAMETERS: code - glyph display code
+*  DESCRIPTION: Returns TRUE if code is in the shadow buffer or on the panel.
+*****************************************************************************************/
+static INT8U lcdGlyphOnDisplay(const INT8C code) {
+    INT8U row;
+    INT8U col;
+    INT8U found = FALSE;
+    for(row = 0; row < NUM_ROWS; row++){
+        for(col = 0; col < NUM_CHARS; col++){
+            if((lcdShadow[row][col] == code) || (lcdPanel[row][col] == code)){
+                found = TRUE;
+            }else{
+            }
+        }
+    }
+    return found;
+}
+
+/*****************************************************************************************
+* LcdDispIcon()
+*  PARAMETERS: icon - one of the LCD_ICON values
+*  DESCRIPTION: Displays a built-in icon at the current cursor location.
+*****************************************************************************************/
+void LcdDispIcon(const LCD_ICON icon) {
+    if(icon < LCD_ICON_NUM){
+        LcdDispChar(LcdGlyph(lcdIconGlyphs[icon]));
+    }else{
+    }
+}
+
+/*****************************************************************************************
+* LcdDispBar()
+*  PARAMETERS: width - bar width in characters, value - level to show, max - full scale.
+*  DESCRIPTION: Draws a horizontal bar graph at the current cursor location with five
+*               steps per character. Full characters use the ROM block, so at most one
+*               partial glyph is needed per bar.
+*****************************************************************************************/
+void LcdDispBar(const INT8U width, const INT32U value, const INT32U max) {
+    INT32U cols;
+    INT8U i;
+
+    if((max == 0) || (value >= max)){
+        cols = (INT32U)width*LCD_BAR_COLS;
+    }else{
+        cols = (INT32U)(((INT64U)value*width*LCD_BAR_COLS)/max);
+    }
+    for(i = 0; i < width; i++){
+        if(cols >= LCD_BAR_COLS){
+            LcdDispChar(LCD_FULL_BLOCK);
+            cols -= LCD_BAR_COLS;
+        }else if(cols > 0){
+            LcdDispChar(LcdGlyph(lcdBarGlyphs[cols - 1U]));
+            cols = 0;
+        }else{
+            LcdDispChar(' ');
+        }
+    }
+}
+
+/*****************************************************************************************
+* LcdPrintf()
+*  PARAMETERS: fmt - printf style format string followed by its arguments.
+*  DESCRIPTION: Formats into a one line buffer then displays it. Anything past the end of
+*               the line would be dropped by LcdDispChar() anyway.
+*****************************************************************************************/
+void LcdPrintf(const INT8C *fmt, ...) {
+    INT8C linestrg[NUM_CHARS + 1];
+    va_list args;
+
+    va_start(args, fmt);
+    (void)FmtVSPrintf(linestrg, (INT8U)sizeof(linestrg), fmt, args);
+    va_end(args);
+    LcdDispString(linestrg);
+}
+
 /*********************************************************************************************
 * LcdDispDecWord() - Outputs a decimal value of a 32-bit word.
 *    Parameters: binword - is the word to be sent,
@@ -254,72 +865,9 @@ void LcdDispString(INT8C *const strg) {
 * Contributions from Brad Cowgill
 *********************************************************************************************/
 void LcdDispDecWord(INT32U binword, INT8U field, LCD_MODE mode){
-    INT8C digitstrg[11];
-    INT32U lbinword = binword;
-    INT8U num_digits = field;
-    INT8U digit_index;
-    INT8U val_index;
-
-    //Clamp field size to acceptable values
-    if(num_digits > 10){
-        num_digits = 10;
-    }else if(num_digits < 1){
-        num_digits = 1;
-    }else{
-    }
-   //Calculate the digits needed for lbinword
-    digit_index = num_digits + 1;
-    digit_index--;
-    digitstrg[digit_index] = '\0';   //always ends in null
-    while((digit_index > 0) && (lbinword > 0)){
-        digit_index--;
-        digitstrg[digit_index] = (INT8C)((lbinword % 10) +'0');
-        lbinword = lbinword/10;
-    }
-
-    if(digit_index == num_digits){       //always at least a '0'
-        digit_index--;
-        digitstrg[digit_index] = '0';
-    }else{
-    }
-    if(lbinword > 0){  //Writes '-' to all field slots if bin length exceeded field
-        digit_index = 0;
-        while(digit_index < num_digits){
-            digitstrg[digit_index] = '-';
-            digit_index++;
-        }
-        digitstrg[digit_index] = '\0';
-        LcdDispString(digitstrg);
-    }else{
-        if((mode == LCD_DEC_MODE_AR) || (mode == LCD_DEC_MODE_LZ)){   //align right so fill rest with spaces to clear
-            while(digit_index > 0){
-                digit_index--;
-                if(mode == LCD_DEC_MODE_AR){
-                    digitstrg[digit_index] = ' ';
-                }else if(mode == LCD_DEC_MODE_LZ){
-                    digitstrg[digit_index] = '0';
-                }else{
-                }
-            }
-            LcdDispString(digitstrg);
-
-        }else if(mode == LCD_DEC_MODE_AL){
-            val_index = digit_index;
-            digit_index = 0;
-            while(val_index < (num_digits)){
-                digitstrg[digit_index] = digitstrg[val_index];
-                val_index++;
-                digit_index++;
-            }
-            while(digit_index < num_digits){
-                digitstrg[digit_index] = ' ';
-                digit_index++;
-            }
-            digitstrg[(digit_index)] = '\0';
-            LcdDispString(digitstrg);
-        }else{
-        }
-    }
+    INT8C digitstrg[FMT_DEC_MAX_DIGITS + 1U];
+    (void)FmtDecWord(digitstrg, binword, field, (FMT_DEC_MODE)mode);  //Same mode order
+    LcdDispString(digitstrg);
 }
 
 
@@ -332,9 +880,14 @@ void LcdDispDecWord(INT32U binword, INT8U field, LCD_MODE mode){
 void LcdCursorMove(const INT8U row, const INT8U col) {
 
     if(row == 1) {
-        lcdWrCmd((INT8U)(LCD_LINE1_ADDR + col - 1));
+        lcdCurRow = 0;
     }else{
-        lcdWrCmd((INT8U)(LCD_LINE2_ADDR + col - 1));
+        lcdCurRow = 1;
+    }
+    if((col >= 1) && (col <= NUM_CHARS)){
+        lcdCurCol = (INT8U)(col - 1);
+    }else{
+        lcdCurCol = 0;
     }
 }
 
@@ -351,8 +904,10 @@ void LcdCursorMode(const INT8U on, const INT8U blink) {
     
     if(on == 0){
         curcmd = 0x0CU;     //Cursor off
+        lcdCursorOn = FALSE;
     }else{
         curcmd = 0x0EU;     //Cursor on
+        lcdCursorOn = TRUE;
     }
     if(blink != 0) {
         curcmd |= 0x01;     //Cursor blink
@@ -365,40 +920,14 @@ void LcdCursorMode(const INT8U on, const INT8U blink) {
 /*****************************************************************************************
 ** lcdDly500ns(void)
 *  	Delays, at least, 500ns
-*   Designed for 180MHz max clock.
- * 	Tdly >= (45ns)i (at 180MHz)
- * Currently set to ~540ns with i=12.
+*   Waits lcdDlyCyc cycles of the DWT cycle counter, set for the current core clock.
  * TDM 01/20/2013
  * TDM 11/03/2015
 *****************************************************************************************/
 static void lcdDly500ns(void){
-	INT32U i;
-	for(i=0;i<12;i++){
-	}
-}
-
-/*****************************************************************************************
-** lcdDly40us(void)
-* 	Clock frequency independent because it uses lcdDly500ns.
-*****************************************************************************************/
-static void lcdDly40us(void){
-    INT8U cnt;
-    for(cnt=80;cnt > 0;cnt--){
-        lcdDly500ns();
-    }
-}
-
-/*****************************************************************************************
-** lcdDlyms(INT8U ms)
-*   Delays, at least, ms milliseconds. Maximum ~255ms.
-*   Note, based on lcdDly500ns() so not very accurate but always greater than ms
-*   milliseconds
-*****************************************************************************************/
-static void lcdDlyms(const INT8U ms){
-    INT32U cnt;
-    for(cnt = (INT32U)ms*2000;cnt > 0;cnt--){
-        lcdDly500ns();
-    }
+    INT32U start;
+    start = DWT->CYCCNT;
+    while((DWT->CYCCNT - start) < lcdDlyCyc){}
 }
 
 /*****************************************************************************************
@@ -406,7 +935,10 @@ static void lcdDlyms(const INT8U ms){
 *   Moves cursor back one space.
 *****************************************************************************************/
 void LcdBSpace(void) {
-    lcdWrCmd(LCD_BS_CMD);
+    if(lcdCurCol > 0){
+        lcdCurCol--;
+    }else{
+    }
 }
 
 /*****************************************************************************************
@@ -414,20 +946,23 @@ void LcdBSpace(void) {
 *   Moves cursor right one space.
 *****************************************************************************************/
 void LcdFSpace(void) {
-    lcdWrCmd(LCD_FS_CMD);
+    if(lcdCurCol < NUM_CHARS){
+        lcdCurCol++;
+    }else{
+    }
 }
-/*******************************************************************************************
-* lcdHtoA() - Converts a hex nibble to ASCII - private
-* hnib is the byte with the LSN to be sent
-*******************************************************************************************/
-static INT8C lcdHtoA(INT8U hnib){
-    INT8C asciic;
-    INT8U hnmask = hnib & 0x0fu; /* Take care of any upper nibbles */
-    if(hnmask <= 9U){
-        asciic = (INT8C)(hnmask + 0x30U);
-    }else{
-        asciic = (INT8C)(hnmask + 0x37U);
-    }
-    return asciic;
-}
 /****************************************************************************************/
+
+/*****************************************************************************************
+** LcdClkChange() - Clock change callback, see K65TWR_ClkRegister(). The PIT runs from
+*                   the bus clock, so the operation and wave tick counts are rescaled.
+*                   The E pulse cycle count follows the core clock.
+*                   Change the clock only when LcdIdle(), see there.
+*****************************************************************************************/
+void LcdClkChange(INT32U core_hz, INT32U bus_hz){
+    lcdDlyCyc = LCD_NS_TO_CYC(core_hz, LCD_DLY500NS_NS);
+    lcdBusMHz = (bus_hz + 999999U)/1000000U;    /* Rounded up, FEI is 20.97MHz */
+#if LCD_DMA_EN
+    PIT->CHANNEL[LCD_DMA_CH].LDVAL = LCD_PIT_CNT(LCD_WAVE_TICK_US);
+#endif
+}
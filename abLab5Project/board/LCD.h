@@ -9,9 +9,22 @@
 * Fixed LcdDispDecWord, Todd Morton, 12/13/2017
 * Modified for MCUXpresso, Todd Morton, 10/29/2018
 * Modified for MCUXpresso v11.2, added new LcdDispDecWord(), Todd Morton, 10/31/2020
+* Added shadow display buffer and LcdTask() dirty-cell flushing, 10/18/2026
+* Replaced busy-wait delays with a PIT1 paced operation queue, 10/18/2026
+* Added LcdPrintf(), 10/18/2026
+* Added CGRAM glyph cache, bar graph and icons, 10/18/2026
+* Added LcdGetBusTime(), 10/18/2026
+* Added LcdClkChange(), 10/18/2026
+* Added LcdIdle(), 10/18/2026
+*
+* All display functions write into a 2x16 shadow buffer. Nothing reaches the panel until
+* LcdTask() runs, which then sends only the characters that changed. Bus transfers are
+* queued and sent from PIT1_IRQHandler() so no function here waits on the LCD. PIT1 is
+* reserved for this module.
 *****************************************************************************************/
 #ifndef LCD_INC
 #define LCD_INC
+#include "StrFmt.h"
 /*************************************************************************
 * LCD Rows and Columns Defines
 *************************************************************************/
@@ -47,11 +60,22 @@ typedef enum {
     LCD_DEC_MODE_AL
 } LCD_MODE;
 
+/*************************************************************************
+* Built-in icons for LcdDispIcon()
+*************************************************************************/
+typedef enum {
+    LCD_ICON_LOCK,
+    LCD_ICON_UNLOCK,
+    LCD_ICON_BELL,
+    LCD_ICON_NUM
+} LCD_ICON;
+
 /*****************************************************************************************
 * WWULCD Function prototypes
 *****************************************************************************************/
 /*****************************************************************************************
-* LcdDispInit() Initializes display. Takes ~24ms to run
+* LcdDispInit() Initializes display. Returns immediately, the reset sequence (~24ms) is
+* sent in the background by the PIT1 paced operation queue.
 *****************************************************************************************/
 void LcdDispInit(void);
 
@@ -73,11 +97,32 @@ void LcdDispLineClear(const INT8U line);
 /*****************************************************************************************
 ** LcdDispChar() - Public
 *  PARAMETERS: c - ASCII character to be sent to the LCD
-*  DESCRIPTION: Displays a character at current LCD address. Assumes that the LCD port is
-*               configured for a data write.
+*  DESCRIPTION: Displays a character at current LCD address. Characters past column 16
+*               are dropped.
 *****************************************************************************************/
 void LcdDispChar(const INT8C c);
 
+/*****************************************************************************************
+** LcdTask() - Public
+*  DESCRIPTION: Cooperative task that writes the changed cells of the shadow buffer to
+*               the panel. Call once per time slice.
+*****************************************************************************************/
+void LcdTask(void);
+
+/*****************************************************************************************
+** LcdGetBusTime() - Public
+*  RETURN VALUE: Total LCD bus time in microseconds since LcdDispInit(). Read it before
+*                and after a call to find that call's bus time.
+*****************************************************************************************/
+INT32U LcdGetBusTime(void);
+
+/*****************************************************************************************
+** LcdIdle() - Public
+*  RETURN VALUE: TRUE when nothing is queued or settling. Wait for it before a clock
+*                change, LcdClkChange() does not rescale a settle time already running.
+*****************************************************************************************/
+INT8U LcdIdle(void);
+
 /*****************************************************************************************
 * LcdDispHexWord()
 *  PARAMETERS: word - word to be displayed.
@@ -93,6 +138,40 @@ void LcdDispHexWord(const INT32U word, const INT8U num_nib);
 *****************************************************************************************/
 void LcdDispString(INT8C *const strg);
 
+/*****************************************************************************************
+* LcdPrintf()
+*  PARAMETERS: fmt - printf style format string followed by its arguments.
+*  DESCRIPTION: Formats into a one line buffer with FmtVSPrintf() then displays it at the
+*               current cursor location. Supports %d %u %x %X %c %s with width, '-' and '0'.
+*               Arguments are checked against fmt at compile time.
+*****************************************************************************************/
+void LcdPrintf(const INT8C *fmt, ...) FMT_PRINTF_CHECK(1,2);
+
+/*****************************************************************************************
+* LcdGlyph()
+*  PARAMETERS: pattern - pointer to a constant 8-byte glyph, one byte per pixel row with
+*              the pixels in the 5 LSBs. The pointer is the cache key so it must stay valid.
+*  DESCRIPTION: Returns the character code for pattern, to be used with LcdDispChar() or
+*               in a string. The eight CGRAM slots are an LRU cache, a pattern is only
+*               uploaded when it is not already resident.
+*****************************************************************************************/
+INT8C LcdGlyph(const INT8U *const pattern);
+
+/*****************************************************************************************
+* LcdDispIcon()
+*  PARAMETERS: icon - LCD_ICON_LOCK, LCD_ICON_UNLOCK or LCD_ICON_BELL
+*  DESCRIPTION: Displays a built-in icon at the current cursor location.
+*****************************************************************************************/
+void LcdDispIcon(const LCD_ICON icon);
+
+/*****************************************************************************************
+* LcdDispBar()
+*  PARAMETERS: width - bar width in characters, value - level to show, max - full scale.
+*  DESCRIPTION: Draws a horizontal bar graph with 5 steps per character at the current
+*               cursor location.
+*****************************************************************************************/
+void LcdDispBar(const INT8U width, const INT32U value, const INT32U max);
+
 /*********************************************************************************************
 * LcdDispDecWord() - Outputs a decimal value of a 32-bit word.
 *    Parameters: binword - is the word to be sent,
@@ -140,5 +219,11 @@ void LcdBSpace(void);
 *****************************************************************************************/
 void LcdFSpace(void);
 
+/*****************************************************************************************
+** LcdClkChange() - Clock change callback for K65TWR_ClkRegister(). Rescales the PIT
+*                   counts of the LCD timing to the new bus clock. Only while LcdIdle().
+*****************************************************************************************/
+void LcdClkChange(INT32U core_hz, INT32U bus_hz);
+
 /****************************************************************************************/
 #endif
@@ -0,0 +1,378 @@
+/*****************************************************************************************
+* StrFmt.c - Shared integer to text conversion for LCD.c and BasicIO.c.
+*            Decimal digits are produced two at a time. The quotient by 100 is found with
+*            a 32x32->64 multiply by the reciprocal (2^37/100, rounded up) and a shift,
+*            which is exact for every INT32U, and the remainder indexes a digit-pair
+*            table. A 10 digit word takes 4 multiplies instead of 10 divides.
+* 10/18/2026 Initial version
+* 10/18/2026 Added FmtVSPrintf()
+* 10/18/2026 FmtDecWord() counts the digits first and writes them in place, no copy
+*****************************************************************************************/
+#include "MCUType.h"
+#include "StrFmt.h"
+
+/*****************************************************************************************
+* Private Resources
+*****************************************************************************************/
+#define FMT_RECIP_100       0x51EB851FU     /* ceil(2^37/100) */
+#define FMT_RECIP_100_SHIFT 37U
+#define FMT_DIV100(n)       ((INT32U)(((INT64U)(n)*FMT_RECIP_100) >> FMT_RECIP_100_SHIFT))
+
+static const INT8C fmtDigitPairs[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'};
+
+static const INT32U fmtPow10[FMT_DEC_MAX_DIGITS] = {
+    1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U};
+
+static const INT8C fmtHexDigits[16] = {
+    '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'};
+
+#define FMT_FLAG_LEFT   0x01U       /* '-' flag */
+#define FMT_FLAG_ZERO   0x02U       /* '0' flag */
+
+static INT8U fmtDigits(INT8C *const end, INT32U binword);
+static INT8U fmtClampField(INT8U field);
+static INT8U fmtPutField(INT8C *const strg, INT8U index, INT8U size, const INT8C *field,
+                         INT8U len, INT8U width, INT8U flags, INT8C sign);
+
+/*****************************************************************************************
+* fmtDigits() - Writes the significant decimal digits of binword backwards, ending just
+*               before end. Always writes at least a '0'.
+*               Returns the number of digits written.
+* (Private)
+*****************************************************************************************/
+static INT8U fmtDigits(INT8C *const end, INT32U binword){
+    INT8C *dptr = end;
+    INT32U lbinword = binword;
+    INT32U quot;
+    INT32U pair;
+
+    while(lbinword >= 100U){
+        quot = FMT_DIV100(lbinword);
+        pair = (lbinword - (quot*100U))*2U;
+        dptr -= 2;
+        dptr[0] = fmtDigitPairs[pair];
+        dptr[1] = fmtDigitPairs[pair + 1U];
+        lbinword = quot;
+    }
+    if(lbinword >= 10U){
+        pair = lbinword*2U;
+        dptr -= 2;
+        dptr[0] = fmtDigitPairs[pair];
+        dptr[1] = fmtDigitPairs[pair + 1U];
+    }else{
+        dptr--;
+        *dptr = (INT8C)('0' + lbinword);
+    }
+    return (INT8U)(end - dptr);
+}
+
+/*****************************************************************************************
+* fmtClampField() - Clamps a field size to 1-10 digits.
+* (Private)
+*****************************************************************************************/
+static INT8U fmtClampField(INT8U field){
+    INT8U num_digits = field;
+    if(num_digits > FMT_DEC_MAX_DIGITS){
+        num_digits = FMT_DEC_MAX_DIGITS;
+    }else if(num_digits < 1){
+        num_digits = 1;
+    }else{
+    }
+    return num_digits;
+}
+
+/*****************************************************************************************
+* FmtDecWord() - Converts a 32-bit word to a decimal string of exactly field characters.
+*                See StrFmt.h for modes and examples.
+* (Public)
+*****************************************************************************************/
+INT8U FmtDecWord(INT8C *const strg, INT32U binword, INT8U field, FMT_DEC_MODE mode){
+    INT8U num_digits = fmtClampField(field);
+    INT8U val_digits = 1;
+    INT8U index = 0;
+    INT8U pad;
+
+    while((val_digits < FMT_DEC_MAX_DIGITS) && (binword >= fmtPow10[val_digits])){
+        val_digits++;
+    }
+    if(val_digits > num_digits){    //Writes '-' to all field slots if field exceeded
+        while(index < num_digits){
+            strg[index] = '-';
+            index++;
+        }
+    }else if(mode == FMT_DEC_MODE_AL){
+        index = fmtDigits(&strg[val_digits], binword);
+        while(index < num_digits){
+            strg[index] = ' ';
+            index++;
+        }
+    }else{                          //Digits go straight to the end of the field
+        (void)fmtDigits(&strg[num_digits], binword);
+        pad = (INT8U)(num_digits - val_digits);
+        while(index < pad){
+            strg[index] = (mode == FMT_DEC_MODE_LZ) ? '0' : ' ';
+            index++;
+        }
+        index = num_digits;
+    }
+    strg[index] = '\0';
+    return index;
+}
+
+/*****************************************************************************************
+* FmtFixWord() - Converts a fixed-point word to a decimal string with a decimal point.
+*                The word is converted once with leading zeros, then the integer digits
+*                are aligned and the point inserted, so no division by 10^frac is needed.
+*                See StrFmt.h for parameters.
+* (Public)
+*****************************************************************************************/
+INT8U FmtFixWord(INT8C *const strg, INT32U binword, INT8U field, INT8U frac,
+                 FMT_DEC_MODE mode){
+    INT8C digits[FMT_DEC_MAX_DIGITS + 1U];
+    INT8U num_digits = fmtClampField(field);
+    INT8U lfrac = frac;
+    INT8U int_digits;
+    INT8U lead = 0;
+    INT8U index;
+    INT8U out_index = 0;
+
+    if(lfrac >= num_digits){
+        lfrac = (INT8U)(num_digits - 1U);
+    }else{
+    }
+    int_digits = (INT8U)(num_digits - lfrac);
+    (void)FmtDecWord(digits, binword, num_digits, FMT_DEC_MODE_LZ);
+    if(mode != FMT_DEC_MODE_LZ){            //Count leading zeros to suppress
+        while((lead < (int_digits - 1U)) && (digits[lead] == '0')){
+            lead++;
+        }
+    }else{
+    }
+    if(mode == FMT_DEC_MODE_AR){
+        while(out_index < lead){
+            strg[out_index] = ' ';
+            out_index++;
+        }
+    }else{
+    }
+    for(index = lead; index < num_digits; index++){
+        if(index == int_digits){
+            strg[out_index] = '.';
+            out_index++;
+        }else{
+        }
+        strg[out_index] = digits[index];
+        out_index++;
+    }
+    if(mode == FMT_DEC_MODE_AL){
+        for(index = 0; index < lead; index++){
+            strg[out_index] = ' ';
+            out_index++;
+        }
+    }else{
+    }
+    strg[out_index] = '\0';
+    return out_index;
+}
+
+/*****************************************************************************************
+* FmtHexWord() - Converts num_nib nibbles of word to upper case hex.
+* (Public)
+*****************************************************************************************/
+INT8U FmtHexWord(INT8C *const strg, INT32U word, INT8U num_nib){
+    INT8U index = 0;
+    INT8U currentnib;
+    if((num_nib > 0) && (num_nib <= 8)){
+        currentnib = num_nib;
+        while(currentnib > 0){
+            strg[index] = fmtHexDigits[(word >> ((currentnib - 1U)*4U)) & 0x0FU];
+            index++;
+            currentnib--;
+        }
+    }else{
+    }
+    strg[index] = '\0';
+    return index;
+}
+
+/*****************************************************************************************
+* FmtVSPrintf() - A small printf into a fixed buffer. See StrFmt.h for the supported
+*                 conversions. Numbers are converted with fmtDigits() into a local buffer
+*                 so the stack use is fixed at about 16 bytes plus locals.
+*                 int and long are both 32 bits on the K65 so all integer arguments are
+*                 fetched as 32-bit words.
+* (Public)
+*****************************************************************************************/
+INT8U FmtVSPrintf(INT8C *const strg, INT8U size, const INT8C *fmt, va_list args){
+    INT8C numstrg[FMT_DEC_MAX_DIGITS];
+    const INT8C *fptr = fmt;
+    const INT8C *field;
+    INT8U index = 0;
+    INT8U flags;
+    INT8U width;
+    INT8U len;
+    INT8C sign;
+    INT8U i;
+    INT32S sval;
+    INT32U uval;
+
+    while((*fptr != '\0') && (size > 0U) && (index < (INT8U)(size - 1U))){
+        if(*fptr != '%'){
+            strg[index] = *fptr;
+            index++;
+            fptr++;
+        }else{
+            fptr++;
+            flags = 0;
+            width = 0;
+            sign = '\0';
+            len = 0;
+            field = numstrg;
+            while((*fptr == '-') || (*fptr == '0')){
+                if(*fptr == '-'){
+                    flags |= FMT_FLAG_LEFT;
+                }else{
+                    flags |= FMT_FLAG_ZERO;
+                }
+                fptr++;
+            }
+            while((*fptr >= '0') && (*fptr <= '9')){
+                width = (INT8U)((width*10U) + (INT8U)(*fptr - '0'));
+                fptr++;
+            }
+            if(*fptr == 'l'){
+                fptr++;
+            }else{
+            }
+            switch(*fptr){
+            case 'd':
+            case 'i':
+                sval = va_arg(args, INT32S);
+                if(sval < 0){
+                    sign = '-';
+                    uval = (INT32U)0 - (INT32U)sval;
+                }else{
+                    uval = (INT32U)sval;
+                }
+                len = fmtDigits(&numstrg[FMT_DEC_MAX_DIGITS], uval);
+                field = &numstrg[FMT_DEC_MAX_DIGITS - len];
+                break;
+            case 'u':
+                uval = va_arg(args, INT32U);
+                len = fmtDigits(&numstrg[FMT_DEC_MAX_DIGITS], uval);
+                field = &numstrg[FMT_DEC_MAX_DIGITS - len];
+                break;
+            case 'x':
+            case 'X':
+                uval = va_arg(args, INT32U);
+                len = 8;
+                while((len > 1U) && (((uval >> ((len - 1U)*4U)) & 0x0FU) == 0U)){
+                    len--;
+                }
+                (void)FmtHexWord(numstrg, uval, len);
+                if(*fptr == 'x'){
+                    for(i = 0; i < len; i++){
+                        if(numstrg[i] >= 'A'){
+                            numstrg[i] = (INT8C)(numstrg[i] + ('a' - 'A'));
+                        }else{
+                        }
+                    }
+                }else{
+                }
+                break;
+            case 'c':
+                numstrg[0] = (INT8C)va_arg(args, INT32S);
+                len = 1;
+                break;
+            case 's':
+                field = va_arg(args, const INT8C *);
+                while((field[len] != '\0') && (len < 0xFFU)){
+                    len++;
+                }
+                flags &= (INT8U)~FMT_FLAG_ZERO;
+                break;
+            case '%':
+                numstrg[0] = '%';
+                len = 1;
+                break;
+            default:                        /* Unsupported, printed as text without the '%' */
+                fptr--;
+                break;
+            }
+            if(*fptr != '\0'){
+                fptr++;
+            }else{
+            }
+            index = fmtPutField(strg, index, size, field, len, width, flags, sign);
+        }
+    }
+    if(size > 0U){
+        strg[index] = '\0';
+    }else{
+    }
+    return index;
+}
+
+/*****************************************************************************************
+* fmtPutField() - Copies a converted field into strg at index with the sign, padding and
+*                 justification asked for. Stops at size - 1. Returns the new index.
+* (Private)
+*****************************************************************************************/
+static INT8U fmtPutField(INT8C *const strg, INT8U index, INT8U size, const INT8C *field,
+                         INT8U len, INT8U width, INT8U flags, INT8C sign){
+    INT8U lindex = index;
+    INT8U limit = (INT8U)(size - 1U);
+    INT8U total = len;
+    INT8U pad = 0;
+    INT8U i;
+
+    if(sign != '\0'){
+        total++;
+    }else{
+    }
+    if(width > total){
+        pad = (INT8U)(width - total);
+    }else{
+    }
+    if(((flags & FMT_FLAG_LEFT) == 0) && ((flags & FMT_FLAG_ZERO) == 0)){
+        for(i = 0; (i < pad) && (lindex < limit); i++){
+            strg[lindex] = ' ';
+            lindex++;
+        }
+    }else{
+    }
+    if((sign != '\0') && (lindex < limit)){
+        strg[lindex] = sign;
+        lindex++;
+    }else{
+    }
+    if(((flags & FMT_FLAG_LEFT) == 0) && ((flags & FMT_FLAG_ZERO) != 0)){
+        for(i = 0; (i < pad) && (lindex < limit); i++){
+            strg[lindex] = '0';
+            lindex++;
+        }
+    }else{
+    }
+    for(i = 0; (i < len) && (lindex < limit); i++){
+        strg[lindex] = field[i];
+        lindex++;
+    }
+    if((flags & FMT_FLAG_LEFT) != 0){
+        for(i = 0; (i < pad) && (lindex < limit); i++){
+            strg[lindex] = ' ';
+            lindex++;
+        }
+    }else{
+    }
+    return lindex;
+}
@@ -0,0 +1,90 @@
+/*****************************************************************************************
+* StrFmt.h - Shared integer to text conversion for LCD.c and BasicIO.c. All functions
+*            write into a caller supplied string so the caller can send it in one batch.
+*            Decimal conversion is division-free: two digits are produced per step using
+*            a reciprocal multiply for /100 and a digit-pair table.
+* 10/18/2026 Initial version, replaces the digit loops in LcdDispDecWord() and
+*            BIOOutDecWord().
+* 10/18/2026 Added FmtVSPrintf() for LcdPrintf() and BIOPrintf().
+*****************************************************************************************/
+#ifndef STRFMT_INC
+#define STRFMT_INC
+
+#include <stdarg.h>
+
+/*****************************************************************************************
+* FMT_PRINTF_CHECK(f,a) - Marks a function as taking a printf style format string in
+*                         parameter f with arguments starting at parameter a, so GCC checks
+*                         the arguments against the format at compile time.
+*****************************************************************************************/
+#ifdef __GNUC__
+#define FMT_PRINTF_CHECK(f,a) __attribute__((format(printf,(f),(a))))
+#else
+#define FMT_PRINTF_CHECK(f,a)
+#endif
+
+/*****************************************************************************************
+* Enumerated type for mode parameter in FmtDecWord() and FmtFixWord(). Same order as
+* LCD_MODE and BIO_OUTDEC_MODE.
+*****************************************************************************************/
+typedef enum {
+    FMT_DEC_MODE_LZ,
+    FMT_DEC_MODE_AR,
+    FMT_DEC_MODE_AL
+} FMT_DEC_MODE;
+
+#define FMT_DEC_MAX_DIGITS 10U      /* Digits in the largest INT32U */
+
+/*****************************************************************************************
+* FmtDecWord() - Converts a 32-bit word to a decimal string of exactly field characters.
+*    Parameters: strg - destination, must hold field + 1 characters.
+*                binword - is the word to be converted,
+*                field - is the number of characters. Range 1-10.
+*                mode - determines the behavior of field and binword,
+*                3 modes:
+*                   1. FMT_DEC_MODE_LZ: Shows leading zeros (digits will use entire field).
+*                   2. FMT_DEC_MODE_AR: Aligns binword to rightmost field digits.
+*                   3. FMT_DEC_MODE_AL: Aligns binword to leftmost field digits.
+*    Examples:
+*    binword = 123, field = 5, mode = FMT_DEC_MODE_LZ, Result: 00123
+*    binword = 123, field = 5, mode = FMT_DEC_MODE_AR, Result: XX123 (Xs are spaces)
+*    binword = 123, field = 5, mode = FMT_DEC_MODE_AL, Result: 123XX
+*    binword = 123, field = 2, mode = FMT_DEC_MODE_LZ, Result: --    (binword exceeds field)
+*    Returns: the number of characters written, not including the NULL.
+*****************************************************************************************/
+INT8U FmtDecWord(INT8C *const strg, INT32U binword, INT8U field, FMT_DEC_MODE mode);
+
+/*****************************************************************************************
+* FmtFixWord() - Converts a 32-bit fixed-point word, binword/(10^frac), to a decimal
+*                string with a decimal point.
+*    Parameters: strg - destination, must hold field + 2 characters.
+*                field - total number of digits, integer plus fraction. Range 1-10.
+*                frac - number of fraction digits. Must be less than field.
+*                mode - alignment of the integer digits, see FmtDecWord(). Fraction
+*                       digits always show leading zeros.
+*    Example: binword = 12345, field = 6, frac = 2, mode = FMT_DEC_MODE_AR, Result: X123.45
+*    Returns: the number of characters written, not including the NULL.
+*****************************************************************************************/
+INT8U FmtFixWord(INT8C *const strg, INT32U binword, INT8U field, INT8U frac,
+                 FMT_DEC_MODE mode);
+
+/*****************************************************************************************
+* FmtHexWord() - Converts the least significant num_nib nibbles of word to upper case hex.
+*    Parameters: strg - destination, must hold num_nib + 1 characters.
+*                num_nib - number of nibbles, from least sig. to most sig. Range 1-8.
+*    Returns: the number of characters written, 0 if num_nib is out of range.
+*****************************************************************************************/
+INT8U FmtHexWord(INT8C *const strg, INT32U word, INT8U num_nib);
+
+/*****************************************************************************************
+* FmtVSPrintf() - A small printf into a fixed buffer. No heap and no floating point.
+*    Supported: %d %i %u %x %X %c %s %%
+*               flags '-' (left justify) and '0' (zero pad), a decimal width and an
+*               optional 'l' length, which is ignored since int and long are both 32 bits.
+*    Parameters: strg - destination, size - size of strg including the NULL.
+*    Returns: the number of characters written, not including the NULL. Output that does
+*             not fit is dropped.
+*****************************************************************************************/
+INT8U FmtVSPrintf(INT8C *const strg, INT8U size, const INT8C *fmt, va_list args);
+
+#endif
@@ -9,6 +9,12 @@
 * 10/23/2018 Todd Morton
 * v4.1 Modified for MCUX11.2
 * 10/21/2020 Todd Morton
+* v4.2 Added slice busy time statistics, SysTickGetSliceStats()
+* 10/18/2026
+* v4.3 Reload follows the core clock, SysTickClkChange()
+* 10/18/2026
+* v4.4 Added SysTickAdvance() to account for time in stop modes
+* 10/18/2026
 ******************************************************************************************
 * Project master header file
 *****************************************************************************************/
@@ -28,11 +34,14 @@ static volatile INT32U stmsCount;   /* 1ms counter variable */
 static INT32U stSliceCount;   /* 1ms counter variable */
 static INT8U stInitFlag;
 static INT32U stLastEvent;
+static INT32U stWakeCyc;            /* DWT->CYCCNT when the slice started */
+static SYSTICK_STATS_T stStats;
 
 /*****************************************************************************************
 * Module Defines
 *****************************************************************************************/
-#define CLK_PER_MS 180000U          /* Clock cycles per 1ms, (must be < 16777216)        */
+#define CLK_PER_MS 180000U          /* Clock cycles per 1ms at boot, (must be < 16777216) */
+static INT32U stClkPerMs = CLK_PER_MS;  /* Current, set by SysTickClkChange()            */
 
 /*****************************************************************************************
 * SysTickDelay Function
@@ -55,10 +64,20 @@ void SysTickDelay(const INT32U ms){
 void SysTickWaitEvent(const INT32U period){
 	DB0_TURN_ON();
     if(stInitFlag == 1){
+        stStats.busy_us = (INT32U)(((INT64U)(DWT->CYCCNT - stWakeCyc)*1000U)/stClkPerMs);
+        if(stStats.busy_us > stStats.busy_max_us){
+            stStats.busy_max_us = stStats.busy_us;
+        }else{
+        }
+        if(stStats.busy_us > (period*1000U)){
+            stStats.overruns++;
+        }else{
+        }
         while((stmsCount - stLastEvent) < period){}
     }else{
         stInitFlag = 1;
     }
+    stWakeCyc = DWT->CYCCNT;
     stLastEvent = stmsCount;
     stSliceCount++;
     DB0_TURN_OFF();
@@ -72,7 +91,11 @@ void SysTickDlyInit(void){
     stmsCount = 0;
     stSliceCount = 0;
     stLastEvent = 0;
-    (void)SysTick_Config(CLK_PER_MS);
+    SysTickResetSliceStats();
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;     /* DWT cycle counter on */
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    stClkPerMs = CLK_PER_MS;
+    (void)SysTick_Config(stClkPerMs);
 }
 /*****************************************************************************************
 * SysTickGetmsCount() - Get the value of the millisecond counter. Abstract with function
@@ -89,6 +112,47 @@ INT32U SysTickGetmsCount(void){
 INT32U SysTickGetSliceCount(void){
     return stSliceCount;
 }
+/*****************************************************************************************
+* SysTickGetSliceStats() - Copies the slice busy time statistics. The busy time is from
+*                          the start of a slice to the next SysTickWaitEvent() call.
+*****************************************************************************************/
+void SysTickGetSliceStats(SYSTICK_STATS_T *const stats){
+    *stats = stStats;
+}
+
+/*****************************************************************************************
+* SysTickResetSliceStats() - Clears the maximum busy time and the overrun count.
+*****************************************************************************************/
+void SysTickResetSliceStats(void){
+    stStats.busy_us = 0;
+    stStats.busy_max_us = 0;
+    stStats.overruns = 0;
+}
+
+/*****************************************************************************************
+* SysTickClkChange() - Clock change callback, see K65TWR_ClkRegister(). Reloads the
+*                      timer for 1ms at the new core clock. The tick in progress when
+*                      the clock changed may be short or long.
+*****************************************************************************************/
+void SysTickClkChange(INT32U core_hz, INT32U bus_hz){
+    stClkPerMs = core_hz/1000U;
+    SysTick->LOAD = stClkPerMs - 1U;
+    SysTick->VAL = 0;
+}
+
+/*****************************************************************************************
+* SysTickAdvance() - Adds ms to the millisecond counter for time the SysTick did not see,
+*                    such as a low-leakage stop, and starts a new slice from now so the
+*                    stop is not counted as busy time or as an overrun.
+*****************************************************************************************/
+void SysTickAdvance(const INT32U ms){
+    SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;     /* stmsCount is not atomic */
+    stmsCount += ms;
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+    stLastEvent = stmsCount;
+    stWakeCyc = DWT->CYCCNT;
+}
+
 /*****************************************************************************************
 * SysTick_Handler() - System Tick Interrupt Handler.
 *    - setup for a 1ms periodic interrupt.
@@ -9,11 +9,24 @@
 * 11/05/2017 Todd Morton Modify for new header file structure.
 * v3.1 Modify for MCUXpresso and add SysTickmsCount()
 * 10/23/2018 Todd Morton
+* v4.2 Added slice busy time statistics, SysTickGetSliceStats()
+* 10/18/2026
+* v4.3 Added SysTickClkChange()
+* 10/18/2026
+* v4.4 Added SysTickAdvance()
+* 10/18/2026
 *****************************************************************************************
 * Public Function Prototypes 
 ****************************************************************************************/
 #ifndef SYS_TICK_INC
 #define SYS_TICK_INC
+
+/* Slice busy time statistics, see SysTickGetSliceStats() */
+typedef struct{
+    INT32U busy_us;         /* Last slice */
+    INT32U busy_max_us;     /* Longest since the last reset */
+    INT32U overruns;        /* Slices busy longer than the period */
+}SYSTICK_STATS_T;
 /****************************************************************************************
  * SysTickDelay()
  * Blocking delay routine. The parameter is the number of ms to delay.
@@ -47,4 +60,23 @@ INT32U SysTickGetmsCount(void);
 *****************************************************************************************/
 INT32U SysTickGetSliceCount(void);
 
+/*****************************************************************************************
+* SysTickGetSliceStats() - Copies the busy time of the last slice, the longest since
+*                          SysTickResetSliceStats() and the number of overruns.
+*****************************************************************************************/
+void SysTickGetSliceStats(SYSTICK_STATS_T *const stats);
+void SysTickResetSliceStats(void);
+
+/*****************************************************************************************
+* SysTickClkChange() - Clock change callback for K65TWR_ClkRegister(). Keeps the tick
+*                      at 1ms when the core clock changes.
+*****************************************************************************************/
+void SysTickClkChange(INT32U core_hz, INT32U bus_hz);
+
+/*****************************************************************************************
+* SysTickAdvance() - Moves the millisecond counter ahead by ms spent with the core clock
+*                    stopped, and restarts the slice timing.
+*****************************************************************************************/
+void SysTickAdvance(const INT32U ms);
+
 #endif
@@ -14,10 +14,12 @@
 
 #define CONSTVOLT 0x8000	//a constant which represents half of the full scale voltage of the DAC
 #define HALFSEC 9600		//the number needed to create a half second (triggers on half second, for a 1 second period) (3125*9600=0.5sec)
+#define SAMPLE_RATE 19200U	//64 samples*300Hz sine wave, PIT0 rate
 
 void AlarmWaveInit(void);
 void AlarmWaveControlTask(void);
 void AlarmWaveSetMode(void);
+void AlarmWaveClkChange(INT32U core_hz, INT32U bus_hz);
 void PIT0_IRQHandler(void);
 
 typedef enum {ALARM_OFF, ALARM_ON} ALARM_SET_MODE;
@@ -49,6 +51,11 @@ void AlarmWaveInit(void){
 	NVIC_EnableIRQ(PIT0_IRQn);
 }
 
+//clock change callback, see K65TWR_ClkRegister(), keeps PIT0 at SAMPLE_RATE on the new bus clock
+void AlarmWaveClkChange(INT32U core_hz, INT32U bus_hz){
+	PIT->CHANNEL[0].LDVAL = (bus_hz/SAMPLE_RATE) - 1U;
+}
+
 void AlarmWaveControlTask(void){
 	DB3_TURN_ON();
 	PitEventFlag = 0;
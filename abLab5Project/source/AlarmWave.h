@@ -12,5 +12,6 @@
 void AlarmWaveInit(void);
 void AlarmWaveControlTask(void);
 void AlarmWaveSetMode(void);
+void AlarmWaveClkChange(INT32U core_hz, INT32U bus_hz);
 
 #endif /* ALARMWAVE_H_ */
@@ -15,14 +15,54 @@
 #include "SysTickDelay.h"
 #include "AlarmWave.h"
 #include "K65TWR_TSI.h"
+#include "BasicIO.h"
+#include "TSIStream.h"
+#include "Telemetry.h"
+#include "Shell.h"
+#include "Sleep.h"
 
 #define POLL_PERIOD 10
 #define LOWADDR (INT32U) 0x00000000		//low memory address
 #define HIGHADRR (INT32U) 0x001FFFFF		//high memory address
+#define BENCH_HIGHADDR (INT32U) 0x0000FFFF	//64KB checksummed per clock profile by 'bench'
+#define BENCH_CHUNK 0x800U					//bytes per slice, about 4ms at 4MHz
+#define LEVEL_BAR_COL 11U					//touch level bar, row 2 columns 11-16
+#define LEVEL_BAR_WIDTH 6U
+#define TSI_STREAM_EN 0U					//TSI tuning telemetry on UART2, see TSIStream.h
+#define TELEM_EN 1U							//state snapshots on UART2, see Telemetry.h
+#define TELEM_PERIOD_MS 100U				//only one of the two streams at a time
+#define CLK_IDLE_MS 5000U					//disarmed and untouched this long, clocks go low
+#define SLEEP_EN 1U							//then LLS until a key or pad, see Sleep.h
+#if TSI_STREAM_EN							//a UART2 stream holds off LLS
+#define STREAM_ON() TRUE
+#elif TELEM_EN
+#define STREAM_ON() TelemIsOn()
+#else
+#define STREAM_ON() FALSE
+#endif
+//no UART2 frame or LCD settle time may run across a clock change, see ClockTask()
+#define CLK_CHANGE_OK() ((BIOTxIdle() == TRUE) && (LcdIdle() == TRUE))
 
 static void ControlDisplayTask(void);
 static void SensorTask(void);
 static void LEDTask(void);
+static void TelemetryTask(void);
+static void ClockTask(void);
+static void ClkCmdTask(void);
+static void CmdStats(INT8U argc, INT8C *argv[]);
+static void CmdTsi(INT8U argc, INT8C *argv[]);
+static void CmdArm(INT8U argc, INT8C *argv[]);
+static void CmdDisarm(INT8U argc, INT8C *argv[]);
+static void CmdCs(INT8U argc, INT8C *argv[]);
+static void CmdPerf(INT8U argc, INT8C *argv[]);
+#if SLEEP_EN
+static void CmdSleep(INT8U argc, INT8C *argv[]);
+#endif
+static void CmdClock(INT8U argc, INT8C *argv[]);
+static void CmdBench(INT8U argc, INT8C *argv[]);
+#if (TSI_STREAM_EN == 0) && TELEM_EN
+static void CmdTelem(INT8U argc, INT8C *argv[]);
+#endif
 
 typedef enum {NO_TOUCH, PAD_1, PAD_2} PAD_TOUCH;
 typedef enum {ALARM_DISARMED, ALARM_ARMED, ALARM_ON} ALARM_STATE;
@@ -32,6 +72,37 @@ static PAD_TOUCH TSIPadTouched = NO_TOUCH;
 static INT16U MiliSecTimer = 0;
 static INT16U TSIFlagsValue = 0;
 static INT8U OnEnter = 0;
+static INT16U ProgramChkSum = 0;
+static INT8C LastKey = 0;
+static INT16U KeyPresses = 0;
+static const TSI_ELECTRODE_T AlarmPads[] = {{BRD_PAD1_CH, BRD_PAD1_OFFSET},
+											{BRD_PAD2_CH, BRD_PAD2_OFFSET}};
+static const INT8C *const AlarmStateNames[] = {"disarmed", "armed", "alarm"};
+//'clock' and 'bench' run one step per slice in ClkCmdTask()
+typedef enum {CLK_CMD_NONE, CLK_CMD_SET, CLK_CMD_BENCH_SWITCH, CLK_CMD_BENCH_MEASURE,
+	CLK_CMD_BENCH_PRINT, CLK_CMD_BENCH_RESTORE} CLK_CMD_STATE;
+static CLK_CMD_STATE ClkCmdState = CLK_CMD_NONE;
+static CLK_PROFILE ClkCmdProfile;			//profile being set or measured
+static CLK_PROFILE ClkCmdPrev;				//put back after 'bench'
+static INT32U ClkCmdAddr;					//next chunk to checksum
+static INT32U ClkCmdCycles;
+//diagnostic commands on UART2, run by ShellTask() between the other tasks
+static const SHELL_CMD_T ShellCmds[] = {
+	{"stats", "uptime and counters", CmdStats},
+	{"tsi", "pad counts, baselines, thresholds", CmdTsi},
+	{"arm", "arm the alarm", CmdArm},
+	{"disarm", "disarm the alarm", CmdDisarm},
+	{"cs", "program checksum", CmdCs},
+	{"perf", "slice and bus times, 'perf reset' clears max", CmdPerf},
+#if SLEEP_EN
+	{"sleep", "time in LLS, wake-ups and wake latency", CmdSleep},
+#endif
+	{"clock", "'clock fei|pee120|pee180|blpi' sets the profile", CmdClock},
+	{"bench", "checksum time in each clock profile", CmdBench},
+#if (TSI_STREAM_EN == 0) && TELEM_EN
+	{"telem", "'telem on' or 'telem off' snapshots", CmdTelem},
+#endif
+};
 
 void main(void){
 	INT16U math_val = 0;
@@ -41,35 +112,328 @@ void main(void){
 	LcdDispInit();
 	KeyInit();
 	AlarmWaveInit();
-	TSIInit();
+	TSIInit(AlarmPads, (INT8U)(sizeof(AlarmPads)/sizeof(AlarmPads[0])));
 	GpioLED8Init();
 	GpioLED9Init();
+	BIOOpen(BIO_BIT_RATE_115200);
+#if TSI_STREAM_EN
+	TSIStreamInit();
+#elif TELEM_EN
+	TelemInit(TELEM_PERIOD_MS);
+#endif
 
 	//Initial program checksum, which is displayed on the second row of the LCD
 	LcdCursorMove(2,1);
 	math_val = CalcChkSum((INT8U *)LOWADDR,(INT8U *)HIGHADRR);
-	LcdDispString("CS: ");
-	LcdDispHexWord(math_val,4);
+	LcdPrintf("CS: %04X", math_val);
+	ProgramChkSum = math_val;
 	LcdCursorMove(1,1);
+	ShellInit(ShellCmds, (INT8U)(sizeof(ShellCmds)/sizeof(ShellCmds[0])));
+	//modules with clock based counts follow the clock mode, see ClockTask()
+	(void)K65TWR_ClkRegister(SysTickClkChange);
+	(void)K65TWR_ClkRegister(AlarmWaveClkChange);
+	(void)K65TWR_ClkRegister(LcdClkChange);
+	(void)K65TWR_ClkRegister(KeyClkChange);
+	(void)K65TWR_ClkRegister(BIOClkChange);
+#if SLEEP_EN
+	SleepInit((INT16U)((1U<<BRD_PAD1_CH)|(1U<<BRD_PAD2_CH)));
+#endif
 
 	while(1){
 		SysTickWaitEvent(POLL_PERIOD);
+		ClockTask();					//first, last slice's UART2 and LCD traffic is done
+		ClkCmdTask();
 		ControlDisplayTask();
 		AlarmWaveControlTask();
 		KeyTask();
 		SensorTask();
 		LEDTask();
+		LcdTask();
+#if TSI_STREAM_EN
+		TSIStreamTask();
+#elif TELEM_EN
+		TelemetryTask();
+#endif
+		ShellTask();
 	}
 }
 
-//handles all TSI scanning
+//shell: uptime, state and the stream and UART counters
+static void CmdStats(INT8U argc, INT8C *argv[]){
+	INT32U txovf;
+	INT32U rxovf;
+	BIOGetOverflows(&txovf, &rxovf);
+	BIOPrintf("up %lums slices %lu\r\n", SysTickGetmsCount(), SysTickGetSliceCount());
+	BIOPrintf("state %s keys %u last %c\r\n", AlarmStateNames[CurrentAlarmState],
+		KeyPresses, (LastKey != 0) ? LastKey : '-');
+	BIOPrintf("uart ovf tx %lu rx %lu\r\n", txovf, rxovf);
+#if TSI_STREAM_EN
+	BIOPrintf("tsi stream dropped %lu\r\n", TSIStreamGetDropped());
+#elif TELEM_EN
+	BIOPrintf("telem skipped %lu\r\n", TelemGetSkipped());
+#endif
+}
+
+//shell: live values of each alarm pad
+static void CmdTsi(INT8U argc, INT8C *argv[]){
+	INT8U i;
+	TSI_TELEM_T pad;
+	for (i = 0; i < (sizeof(AlarmPads)/sizeof(AlarmPads[0])); i++){
+		TSIGetSensorData(AlarmPads[i].channel, &pad);
+		BIOPrintf("ch%2u cnt %5u base %5u thr %5u %3u%% %s\r\n", AlarmPads[i].channel,
+			pad.count, pad.baseline, pad.threshold, TSIGetSensorLevel(AlarmPads[i].channel),
+			((pad.channel & TSI_TELEM_TOUCHED) != 0) ? "touch" : "");
+	}
+}
+
+//shell: same as pressing A
+static void CmdArm(INT8U argc, INT8C *argv[]){
+	if (CurrentAlarmState == ALARM_DISARMED){
+		CurrentAlarmState = ALARM_ARMED;
+		BIOPutStrg("armed\r\n");
+	}else{
+		BIOPrintf("already %s\r\n", AlarmStateNames[CurrentAlarmState]);
+	}
+}
+
+//shell: same as pressing D
+static void CmdDisarm(INT8U argc, INT8C *argv[]){
+	if (CurrentAlarmState != ALARM_DISARMED){
+		if (CurrentAlarmState == ALARM_ARMED){
+			TSIMonitorStop();			//as in ControlDisplayTask()
+		}else{}
+		CurrentAlarmState = ALARM_DISARMED;
+		BIOPutStrg("disarmed\r\n");
+	}else{
+		BIOPutStrg("already disarmed\r\n");
+	}
+}
+
+//shell: checksum taken at start up, the same as on the LCD
+static void CmdCs(INT8U argc, INT8C *argv[]){
+	BIOPrintf("CS: %04X\r\n", ProgramChkSum);
+}
+
+//shell: slice busy time, LCD bus time and UART rate
+static void CmdPerf(INT8U argc, INT8C *argv[]){
+	SYSTICK_STATS_T slice;
+	if ((argc > 1) && (ShellStrEq(argv[1], "reset") == TRUE)){
+		SysTickResetSliceStats();
+		BIOPutStrg("cleared\r\n");
+	}else{
+		SysTickGetSliceStats(&slice);
+		BIOPrintf("slice %luus max %luus of %uus, overruns %lu\r\n", slice.busy_us,
+			slice.busy_max_us, POLL_PERIOD*1000U, slice.overruns);
+		BIOPrintf("lcd bus %luus\r\n", LcdGetBusTime());
+		BIOPrintf("uart %lubps err %d x0.01%%\r\n", BIOGetRate(), BIOGetRateError());
+		BIOPrintf("clock %s %s core %luHz bus %luHz\r\n",
+			K65TWR_ClkProfileName(K65TWR_ClkGetProfile()),
+			(K65TWR_ClkGetMode() == CLK_MODE_LOW) ? "low" : "full",
+			K65TWR_ClkGetCoreHz(), K65TWR_ClkGetBusHz());
+	}
+}
+
+//shell: selects the clock profile used when not idle, see K65TWR_ClkSetProfile().
+//ClkCmdTask() makes the change once UART2 and the LCD are idle and prints the result
+static void CmdClock(INT8U argc, INT8C *argv[]){
+	INT8U p;
+	INT8U found = FALSE;
+	if (ClkCmdState != CLK_CMD_NONE){
+		BIOPutStrg("busy\r\n");
+	}else{
+		if (argc > 1){
+			for (p = 0; p < (INT8U)CLK_NUM_PROFILES; p++){
+				if (ShellStrEq(argv[1], K65TWR_ClkProfileName((CLK_PROFILE)p)) == TRUE){
+					ClkCmdProfile = (CLK_PROFILE)p;
+					ClkCmdState = CLK_CMD_SET;
+					found = TRUE;
+				}else{}
+			}
+		}else{}
+		if (found == FALSE){
+			BIOPutStrg("clock fei|pee120|pee180|blpi\r\n");
+			BIOPrintf("clock %s, core %luHz bus %luHz\r\n",
+				K65TWR_ClkProfileName(K65TWR_ClkGetProfile()), K65TWR_ClkGetCoreHz(),
+				K65TWR_ClkGetBusHz());
+		}else{}
+	}
+}
+
+//shell: the same checksum in every clock profile, interrupts running as in the slices,
+//then back to the profile in use. Run by ClkCmdTask() a chunk per slice
+static void CmdBench(INT8U argc, INT8C *argv[]){
+	if (ClkCmdState != CLK_CMD_NONE){
+		BIOPutStrg("busy\r\n");
+	}else{
+		BIOPutStrg("checksum of 64K of flash in each clock profile\r\n");
+		ClkCmdPrev = K65TWR_ClkGetProfile();
+		ClkCmdProfile = (CLK_PROFILE)0;
+		ClkCmdState = CLK_CMD_BENCH_SWITCH;
+	}
+}
+
+/****************************************************************************************
+* ClkCmdTask() - Runs the 'clock' and 'bench' commands one step per slice so the other
+*             tasks keep their slices. A profile change waits for CLK_CHANGE_OK(), as in
+*             ClockTask(). 'bench' then checksums BENCH_CHUNK bytes per slice, adding up
+*             the cycles of each chunk, prints the profile's line and moves to the next.
+* (private)
+****************************************************************************************/
+static void ClkCmdTask(void){
+	INT32U start;
+	INT32U core_hz;
+	switch (ClkCmdState){
+	case CLK_CMD_SET:
+		if (CLK_CHANGE_OK()){
+			K65TWR_ClkSetProfile(ClkCmdProfile);
+			BIOPrintf("clock %s, core %luHz bus %luHz\r\n",
+				K65TWR_ClkProfileName(K65TWR_ClkGetProfile()), K65TWR_ClkGetCoreHz(),
+				K65TWR_ClkGetBusHz());
+			ClkCmdState = CLK_CMD_NONE;
+		}else{}
+		break;
+	case CLK_CMD_BENCH_SWITCH:
+		if (CLK_CHANGE_OK()){
+			K65TWR_ClkSetProfile(ClkCmdProfile);
+			ClkCmdAddr = LOWADDR;
+			ClkCmdCycles = 0;
+			ClkCmdState = CLK_CMD_BENCH_MEASURE;
+		}else{}
+		break;
+	case CLK_CMD_BENCH_MEASURE:
+		start = DWT->CYCCNT;
+		(void)CalcChkSum((INT8U *)ClkCmdAddr,(INT8U *)(ClkCmdAddr + BENCH_CHUNK - 1U));
+		ClkCmdCycles += DWT->CYCCNT - start;
+		ClkCmdAddr += BENCH_CHUNK;
+		if (ClkCmdAddr > BENCH_HIGHADDR){
+			ClkCmdState = CLK_CMD_BENCH_PRINT;
+		}else{}
+		break;
+	case CLK_CMD_BENCH_PRINT:
+		core_hz = K65TWR_ClkGetCoreHz();
+		BIOPrintf("%-7s %3luMHz %2luMHz %6luus %7lu cycles\r\n",
+			K65TWR_ClkProfileName(ClkCmdProfile), core_hz/1000000U,
+			K65TWR_ClkGetBusHz()/1000000U,
+			(INT32U)((((INT64U)ClkCmdCycles)*1000000U)/core_hz), ClkCmdCycles);
+		if (((INT8U)ClkCmdProfile + 1U) < (INT8U)CLK_NUM_PROFILES){
+			ClkCmdProfile = (CLK_PROFILE)((INT8U)ClkCmdProfile + 1U);
+			ClkCmdState = CLK_CMD_BENCH_SWITCH;
+		}else{
+			ClkCmdState = CLK_CMD_BENCH_RESTORE;
+		}
+		break;
+	case CLK_CMD_BENCH_RESTORE:
+		if (CLK_CHANGE_OK()){
+			K65TWR_ClkSetProfile(ClkCmdPrev);
+			ClkCmdState = CLK_CMD_NONE;
+		}else{}
+		break;
+	default:								//CLK_CMD_NONE
+		break;
+	}
+}
+
+#if SLEEP_EN
+//shell: low-leakage stop totals, awake is the time spent between monitor scans
+static void CmdSleep(INT8U argc, INT8C *argv[]){
+	SLEEP_STATS_T stats;
+	SleepGetStats(&stats);
+	BIOPrintf("sleeps %lu key %lu tsi %lu\r\n", stats.entries, stats.key_wakes,
+		stats.tsi_wakes);
+	BIOPrintf("slept %lums awake %luus\r\n", stats.slept_ms, stats.awake_us);
+	BIOPrintf("wake latency %luus max %luus\r\n", stats.latency_us,
+		stats.latency_max_us);
+}
+#endif
+
+#if (TSI_STREAM_EN == 0) && TELEM_EN
+//shell: snapshots share the UART, so they can be stopped while typing
+static void CmdTelem(INT8U argc, INT8C *argv[]){
+	if ((argc > 1) && (ShellStrEq(argv[1], "on") == TRUE)){
+		TelemEnable(TRUE);
+	}else if ((argc > 1) && (ShellStrEq(argv[1], "off") == TRUE)){
+		TelemEnable(FALSE);
+	}else{
+		BIOPutStrg("telem on|off\r\n");
+	}
+}
+#endif
+
+/****************************************************************************************
+* ClockTask() - Drops the clocks to CLK_MODE_LOW after CLK_IDLE_MS disarmed with no key,
+*             touch or shell input, and goes back to CLK_MODE_FULL on the first one
+*             or a state change. The callbacks registered in main() rescale the timers.
+*             A change waits, and is retried every slice, until CLK_CHANGE_OK() so no
+*             UART2 frame and no LCD settle time runs across a bus clock change. It
+*             runs first in the slice, when the previous slice's output has drained.
+*             With SLEEP_EN the next idle slice stops in LLS until a key or a pad,
+*             and the first key or touch handled after that ends the wake latency.
+*             Not while a UART2 stream is on, its packets would stop, see Sleep.h.
+*             'telem off' lets it sleep. A 'clock' or 'bench' in progress counts as
+*             shell input.
+* (private)
+****************************************************************************************/
+static void ClockTask(void){
+	static INT16U idle_ms = 0;
+	static INT16U last_presses = 0;
+	static INT8U to_full = FALSE;
+	INT8U typed = ShellActive();
+	if (ClkCmdState != CLK_CMD_NONE){
+		typed = TRUE;
+	}else{}
+	if ((CurrentAlarmState == ALARM_DISARMED) && (TSIFlagsValue == 0) &&
+		(KeyPresses == last_presses) && (typed == FALSE)){
+		if (idle_ms < CLK_IDLE_MS){
+			idle_ms += POLL_PERIOD;
+		}else if (K65TWR_ClkGetMode() != CLK_MODE_LOW){
+			if (CLK_CHANGE_OK()){
+				K65TWR_ClkSetMode(CLK_MODE_LOW);
+				to_full = FALSE;
+			}else{}
+#if SLEEP_EN
+		}else if ((STREAM_ON() == FALSE) && (SleepEnter() != SLEEP_WAKE_NONE)){
+			idle_ms = 0;						//a bounce or a light touch sleeps again later
+#endif
+		}else{}
+	}else{
+		idle_ms = 0;
+		last_presses = KeyPresses;
+#if SLEEP_EN
+		SleepResponse();
+#endif
+		to_full = TRUE;
+	}
+	if ((to_full == TRUE) && CLK_CHANGE_OK()){
+		K65TWR_ClkSetMode(CLK_MODE_FULL);		//does nothing if already full
+		to_full = FALSE;
+	}else{}
+}
+
+//reads the touch results collected by the TSI interrupt or DMA
 static void SensorTask(void){
 	DB3_TURN_ON();
 	TSITask();
 	TSIFlagsValue = TSIGetSensorFlags();
+	LcdCursorMove(2,LEVEL_BAR_COL);		//show the stronger pad as a level bar
+	if (TSIGetSensorLevel(BRD_PAD1_CH) > TSIGetSensorLevel(BRD_PAD2_CH)){
+		LcdDispBar(LEVEL_BAR_WIDTH,TSIGetSensorLevel(BRD_PAD1_CH),100U);
+	}else{
+		LcdDispBar(LEVEL_BAR_WIDTH,TSIGetSensorLevel(BRD_PAD2_CH),100U);
+	}
 	DB3_TURN_OFF();
 }
 
+//sends the alarm state, pads and keys with the module's timing snapshot
+static void TelemetryTask(void){
+	TELEM_APP_T app;
+	app.alarm_state = (INT8U)CurrentAlarmState;
+	app.tsi_flags = TSIFlagsValue;
+	app.last_key = LastKey;
+	app.key_presses = KeyPresses;
+	app.checksum = ProgramChkSum;
+	TelemTask(&app);
+}
+
 //handles all LED control
 static void LEDTask(void){
 	DB4_TURN_ON();
@@ -132,29 +496,38 @@ static void LEDTask(void){
 * (private)
 ****************************************************************************************/
 static void ControlDisplayTask(void){
+	INT8C key;
 	DB1_TURN_ON();
+	key = KeyGet();
+	if (key != 0){						//remembered for telemetry
+		LastKey = key;
+		KeyPresses++;
+	}else{}
 	switch (CurrentAlarmState){
 	case ALARM_DISARMED:
 		if (PreviousAlarmState != CurrentAlarmState){		//display "alarm off" on the LCD
 			LcdDispLineClear(1);
-			LcdDispString("DISARMED");
+			LcdDispString("DISARMED ");
+			LcdDispIcon(LCD_ICON_UNLOCK);
 			if (PreviousAlarmState == ALARM_ON){
 				AlarmWaveSetMode();			//toggle the alarm wave mode
 			}else{}
 			PreviousAlarmState = CurrentAlarmState;
 			TSIPadTouched = NO_TOUCH;	//reset the pad touch memory
 		}else{}
-		if (KeyGet() == DC1){			//if a is pressed, set alarm state as armed
+		if (key == DC1){			//if a is pressed, set alarm state as armed
 			CurrentAlarmState = ALARM_ARMED;
 		}else{}
 		break;
 	case ALARM_ARMED:
 		if (PreviousAlarmState != CurrentAlarmState){		//display "alarm on" on the LCD
 			LcdDispLineClear(1);
-			LcdDispString("ARMED");
+			LcdDispString("ARMED ");
+			LcdDispIcon(LCD_ICON_LOCK);
 			PreviousAlarmState = CurrentAlarmState;
+			TSIMonitorStart((1<<BRD_PAD1_CH)|(1<<BRD_PAD2_CH));	//TSI hardware watches the pads
 		}else{}
-		if (KeyGet() == DC4){			//if d is pressed, set alarm state as disarmed
+		if (key == DC4){			//if d is pressed, set alarm state as disarmed
 			CurrentAlarmState = ALARM_DISARMED;
 		}else{}
 		if ((TSIFlagsValue & (1<<BRD_PAD1_CH)) != 0){
@@ -166,16 +539,20 @@ static void ControlDisplayTask(void){
 		}else{
 			//do nothing, since we only want to remove the memory of the pad touch once we become disarmed
 		}
+		if (CurrentAlarmState != ALARM_ARMED){
+			TSIMonitorStop();			//back to scanning for the level display
+		}else{}
 		break;
 	case ALARM_ON:
 		if (PreviousAlarmState != CurrentAlarmState){		//display "alarm on" on the LCD
 			LcdDispLineClear(1);
-			LcdDispString("ALARM");
+			LcdDispString("ALARM ");
+			LcdDispIcon(LCD_ICON_BELL);
 			OnEnter = 1;
 			PreviousAlarmState = CurrentAlarmState;
 			AlarmWaveSetMode();			//toggle the alarm wave mode
 		}else{}
-		if (KeyGet() == DC4){			//if d is pressed, set alarm state as disarmed
+		if (key == DC4){			//if d is pressed, set alarm state as disarmed
 			CurrentAlarmState = ALARM_DISARMED;
 		}else{}
 		break;
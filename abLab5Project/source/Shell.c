@@ -0,0 +1,156 @@
+/********************************************************************************
+ * Shell.c - Line editor and command dispatcher for BasicIO. ShellTask() takes
+ *           at most SHELL_CHARS_PER_SLICE characters from the receive queue
+ *           each call, so unlike BIOGetStrg() it never holds up the other
+ *           tasks. Printable characters are echoed, backspace and delete
+ *           erase, carriage return runs the line. 'help' lists the table.
+ *           ShellActive() tells the application someone is typing.
+ * 10/18/2026
+ ********************************************************************************/
+#include "MCUType.h"
+#include "BasicIO.h"
+#include "Shell.h"
+
+/********************************************************************************
+ * Private Resources
+ ********************************************************************************/
+#define SHELL_LINE_SIZE       48U
+#define SHELL_CHARS_PER_SLICE 8U
+#define SHELL_ASCII_BS        0x08
+#define SHELL_ASCII_DEL       0x7F
+#define SHELL_ASCII_CR        0x0D
+static INT8C shellLine[SHELL_LINE_SIZE];
+static INT8U shellLen;
+static const SHELL_CMD_T *shellTable;
+static INT8U shellNum;
+static INT8U shellRxSeen;              // A character read since ShellActive()
+static void shellRun(void);
+static void shellHelp(void);
+
+/********************************************************************************
+ *   ShellInit: Sets the command table and shows the first prompt.
+ *              BIOOpen() must have been called.
+ *              table - commands, num - number of them
+ ********************************************************************************/
+void ShellInit(const SHELL_CMD_T *const table, INT8U num){
+    shellTable = table;
+    shellNum = num;
+    shellLen = 0;
+    shellRxSeen = FALSE;
+    BIOPutStrg("\r\n> ");
+}
+
+/********************************************************************************
+ *   ShellTask: Cooperative task, call once per slice. Edits the received
+ *              characters into the line and runs it on a carriage return.
+ ********************************************************************************/
+void ShellTask(void){
+    INT8C c;
+    INT8U n = 0;
+    c = BIORead();
+    while((c != '\0') && (n < SHELL_CHARS_PER_SLICE)){
+        shellRxSeen = TRUE;
+        if(c == SHELL_ASCII_CR){
+            BIOOutCRLF();
+            shellLine[shellLen] = '\0';
+            shellRun();
+            shellLen = 0;
+            BIOPutStrg("> ");
+        }else if((c == SHELL_ASCII_BS) || (c == SHELL_ASCII_DEL)){
+            if(shellLen > 0){
+                shellLen--;
+                BIOPutStrg("\b \b");
+            }else{
+            }
+        }else if((c >= ' ') && (c <= '~') && (shellLen < (SHELL_LINE_SIZE - 1U))){
+            shellLine[shellLen] = c;
+            shellLen++;
+            (void)BIOWrite(c);
+        }else{                          //Line full or not printable, ignored
+        }
+        n++;
+        if(n < SHELL_CHARS_PER_SLICE){
+            c = BIORead();
+        }else{
+        }
+    }
+}
+
+/********************************************************************************
+ *   ShellActive: Returns TRUE if ShellTask() has read a character since the
+ *                last call, so the application can stay awake for the user.
+ ********************************************************************************/
+INT8U ShellActive(void){
+    INT8U seen = shellRxSeen;
+    shellRxSeen = FALSE;
+    return seen;
+}
+
+/********************************************************************************
+ *   ShellStrEq: Returns TRUE if the two strings are the same.
+ ********************************************************************************/
+INT8U ShellStrEq(const INT8C *a, const INT8C *b){
+    while((*a != '\0') && (*a == *b)){
+        a++;
+        b++;
+    }
+    return (*a == *b) ? TRUE : FALSE;
+}
+
+/********************************************************************************
+ *   shellRun: Splits shellLine[] into words at spaces and calls the handler
+ *             of the command named by the first one.
+ ********************************************************************************/
+static void shellRun(void){
+    INT8C *argv[SHELL_MAX_ARGS];
+    INT8U argc = 0;
+    INT8U i;
+    INT8U found = FALSE;
+    INT8C *p = shellLine;
+    while((*p != '\0') && (argc < SHELL_MAX_ARGS)){
+        if(*p == ' '){
+            *p = '\0';
+            p++;
+        }else{
+            argv[argc] = p;
+            argc++;
+            while((*p != '\0') && (*p != ' ')){
+                p++;
+            }
+            if(*p == ' '){
+                *p = '\0';
+                p++;
+            }else{
+            }
+        }
+    }
+    if(argc != 0){
+        if(ShellStrEq(argv[0], "help") == TRUE){
+            shellHelp();
+            found = TRUE;
+        }else{
+            for(i = 0; (i < shellNum) && (found == FALSE); i++){
+                if(ShellStrEq(argv[0], shellTable[i].name) == TRUE){
+                    shellTable[i].handler(argc, argv);
+                    found = TRUE;
+                }else{
+                }
+            }
+        }
+        if(found == FALSE){
+            BIOPrintf("%s? try help\r\n", argv[0]);
+        }else{
+        }
+    }else{
+    }
+}
+
+/********************************************************************************
+ *   shellHelp: Lists the command table.
+ ********************************************************************************/
+static void shellHelp(void){
+    INT8U i;
+    for(i = 0; i < shellNum; i++){
+        BIOPrintf("%-8s%s\r\n", shellTable[i].name, shellTable[i].help);
+    }
+}
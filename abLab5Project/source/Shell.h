@@ -0,0 +1,24 @@
+/********************************************************************************
+ * Shell.h - Non-blocking command line over UART2. Received characters are
+ *           edited into a line a few per slice and a finished line is run
+ *           from a const command table given by the application.
+ * 10/18/2026
+ ********************************************************************************/
+#ifndef SHELL_H_
+#define SHELL_H_
+
+#define SHELL_MAX_ARGS 4U           // Command name included
+
+/* One command. The handler gets the words of the line, argv[0] is the name */
+typedef struct{
+    const INT8C *name;
+    const INT8C *help;
+    void (*handler)(INT8U argc, INT8C *argv[]);
+}SHELL_CMD_T;
+
+void ShellInit(const SHELL_CMD_T *const table, INT8U num);
+void ShellTask(void);
+INT8U ShellActive(void);
+INT8U ShellStrEq(const INT8C *a, const INT8C *b);
+
+#endif /* SHELL_H_ */
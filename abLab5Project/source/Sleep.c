@@ -0,0 +1,207 @@
+/********************************************************************************
+ * Sleep.c - Puts the MCU in low-leakage stop (LLS3) until a key or a touch.
+ *           The keypad columns PTC3-PTC6 are LLWU pins P7-P10, woken on the
+ *           falling edge a press makes while KeyIdle() drives the rows low.
+ *           TSI0 is LLWU module 4, it keeps scanning from LPTMR0 in monitor
+ *           mode. The monitor wakes the core at the end of every scan to
+ *           debounce, track the baseline and move to the next pad, so
+ *           SleepEnter() goes straight back into LLS until a pad is flagged
+ *           as touched.
+ *           The SysTick stops with the core, so the time asleep is read from
+ *           the RTC and added with SysTickAdvance().
+ *           LLS is entered from normal RUN only, so CLK_MODE_LOW (PBE on the
+ *           crystal) must be set first and the MCG wakes up in that mode.
+ *           The PLL clock monitor must be off in a stop mode, so MCG_C9
+ *           PLL_CME is cleared before the WFI and set again once the PLL has
+ *           locked after the wake-up.
+ *           VLLS is not used, its wake-up is a reset (see K65TWR_BootClock())
+ *           and the tasks would restart instead of resuming.
+ * 10/18/2026
+ ********************************************************************************/
+#include "MCUType.h"
+#include "K65TWR_ClkCfg.h"
+#include "K65TWR_TSI.h"
+#include "Key.h"
+#include "BasicIO.h"
+#include "SysTickDelay.h"
+#include "Sleep.h"
+
+/********************************************************************************
+ * Private Resources
+ ********************************************************************************/
+#define SLEEP_RTC_HZ        32768U      // RTC prescaler rate, TPR counts
+#define SLEEP_RTC_TPR_MASK  (SLEEP_RTC_HZ - 1U)
+#define SLEEP_PMSTAT_RUN    0x01U
+#define SLEEP_STOPM_LLS     3U
+#define SLEEP_LLSM_LLS3     3U          // All RAM kept
+#define SLEEP_LLWU_FALL     2U          // WUPE falling edge
+#define SLEEP_LLWU_PRIORITY 4U          // After TSI0 and PORTC, they clear the flags
+#define SLEEP_KEY_PF1       (LLWU_PF1_WUF7_MASK)
+#define SLEEP_KEY_PF2       (LLWU_PF2_WUF8_MASK|LLWU_PF2_WUF9_MASK|LLWU_PF2_WUF10_MASK)
+static INT16U sleepTsiMask;
+static volatile INT8U sleepKeyWake;     // Column edge seen by LLWU_IRQHandler()
+static SLEEP_STATS_T sleepStats;
+static INT32U sleepWakeTicks;           // RTC at the last wake-up
+static INT8U sleepWaiting;              // SleepResponse() not called since
+static INT32U sleepRtcTicks(void);
+static INT32U sleepTicksToUs(INT32U ticks);
+void LLWU_IRQHandler(void);
+
+/********************************************************************************
+ *   SleepInit: Starts the RTC counting and sets the LLWU wake-up sources.
+ *              Call after KeyInit() and TSIInit().
+ *              tsi_chmask - pads watched while asleep, bit per channel
+ ********************************************************************************/
+void SleepInit(INT16U tsi_chmask){
+    sleepTsiMask = tsi_chmask;
+    sleepKeyWake = FALSE;
+    sleepWaiting = FALSE;
+    sleepStats.entries = 0;
+    sleepStats.key_wakes = 0;
+    sleepStats.tsi_wakes = 0;
+    sleepStats.slept_ms = 0;
+    sleepStats.awake_us = 0;
+    sleepStats.latency_us = 0;
+    sleepStats.latency_max_us = 0;
+    SIM->SCGC6 |= SIM_SCGC6_RTC_MASK;   //Oscillator started by K65TWR_BootClock()
+    if((RTC->SR & RTC_SR_TIF_MASK) != 0){
+        RTC->SR = 0;
+        RTC->TSR = 0;                   //Clears the invalid flag
+    }else{
+    }
+    RTC->SR = RTC_SR_TCE_MASK;
+    LLWU->PE2 = (INT8U)((LLWU->PE2 & (INT8U)~LLWU_PE2_WUPE7_MASK)|
+                        LLWU_PE2_WUPE7(SLEEP_LLWU_FALL));
+    LLWU->PE3 = (INT8U)((LLWU->PE3 & (INT8U)~(LLWU_PE3_WUPE8_MASK|LLWU_PE3_WUPE9_MASK|
+                                               LLWU_PE3_WUPE10_MASK))|
+                        LLWU_PE3_WUPE8(SLEEP_LLWU_FALL)|LLWU_PE3_WUPE9(SLEEP_LLWU_FALL)|
+                        LLWU_PE3_WUPE10(SLEEP_LLWU_FALL));
+    LLWU->ME |= LLWU_ME_WUME4(1);
+    LLWU->PF1 = SLEEP_KEY_PF1;
+    LLWU->PF2 = SLEEP_KEY_PF2;
+    NVIC_SetPriority(LLWU_IRQn, SLEEP_LLWU_PRIORITY);
+    NVIC_EnableIRQ(LLWU_IRQn);
+}
+
+/********************************************************************************
+ *   SleepEnter: Stops in LLS3 until a key or a watched pad wakes it, then
+ *               corrects the millisecond count and returns the wake-up
+ *               source. Returns SLEEP_WAKE_NONE without stopping unless the
+ *               clock is in CLK_MODE_LOW, the keypad is idle and nothing is
+ *               being sent on UART2. Received bytes are lost while asleep.
+ ********************************************************************************/
+INT8U SleepEnter(void){
+    INT8U wake = SLEEP_WAKE_NONE;
+    INT32U start;
+    INT32U cyc;
+    INT8U cme;
+    if((K65TWR_ClkGetMode() == CLK_MODE_LOW) && (SMC->PMSTAT == SLEEP_PMSTAT_RUN) &&
+       (KeyIdle() == TRUE) && (BIOTxIdle() == TRUE)){
+        TSIMonitorStart(sleepTsiMask);
+        sleepKeyWake = FALSE;
+        start = sleepRtcTicks();
+        cyc = DWT->CYCCNT;              //Stops with the core clock
+        cme = (INT8U)(MCG->C9 & MCG_C9_PLL_CME_MASK);    //Set by pee180
+        MCG->C9 &= (INT8U)~MCG_C9_PLL_CME_MASK;
+        SMC->STOPCTRL = SMC_STOPCTRL_LLSM(SLEEP_LLSM_LLS3);
+        SMC->PMCTRL = (INT8U)((SMC->PMCTRL & (INT8U)~SMC_PMCTRL_STOPM_MASK)|
+                              SMC_PMCTRL_STOPM(SLEEP_STOPM_LLS));
+        (void)SMC->PMCTRL;              //Write done before the WFI
+        SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+        while(wake == SLEEP_WAKE_NONE){
+            __WFI();                    //Returns after the wake-up interrupts
+            if(sleepKeyWake == TRUE){
+                wake |= SLEEP_WAKE_KEY;
+            }else{
+            }
+            if((TSIPeekSensorFlags() & sleepTsiMask) != 0){
+                wake |= SLEEP_WAKE_TSI;
+            }else{
+            }
+        }
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+        sleepWakeTicks = sleepRtcTicks();
+        if(cme != 0){
+            while((MCG->S & MCG_S_LOCK0_MASK) == 0x00U){}
+            MCG->C9 |= cme;
+        }else{
+        }
+        cyc = DWT->CYCCNT - cyc;
+        TSIMonitorStop();
+        if((wake & SLEEP_WAKE_KEY) != 0){
+            KeyWake();
+            sleepStats.key_wakes++;
+        }else{
+        }
+        if((wake & SLEEP_WAKE_TSI) != 0){
+            sleepStats.tsi_wakes++;
+        }else{
+        }
+        start = (INT32U)((((INT64U)(sleepWakeTicks - start))*1000U)/SLEEP_RTC_HZ);
+        SysTickAdvance(start);
+        sleepStats.entries++;
+        sleepStats.slept_ms += start;
+        sleepStats.awake_us += (INT32U)((((INT64U)cyc)*1000000U)/K65TWR_ClkGetCoreHz());
+        sleepWaiting = TRUE;
+    }else{
+    }
+    return wake;
+}
+
+/********************************************************************************
+ *   SleepResponse: Call when the application has acted on the key or touch
+ *                  that woke it. The time from the wake-up is the latency in
+ *                  SleepGetStats(). Calls with no wake-up pending are ignored.
+ ********************************************************************************/
+void SleepResponse(void){
+    if(sleepWaiting == TRUE){
+        sleepWaiting = FALSE;
+        sleepStats.latency_us = sleepTicksToUs(sleepRtcTicks() - sleepWakeTicks);
+        if(sleepStats.latency_us > sleepStats.latency_max_us){
+            sleepStats.latency_max_us = sleepStats.latency_us;
+        }else{
+        }
+    }else{
+    }
+}
+
+/********************************************************************************
+ *   SleepGetStats: Copies the totals since SleepInit()
+ ********************************************************************************/
+void SleepGetStats(SLEEP_STATS_T *const stats){
+    *stats = sleepStats;
+}
+
+/********************************************************************************
+ *   LLWU_IRQHandler: Wake-up from LLS. Module flags are cleared by the module's
+ *                    own handler, the pin flags here.
+ ********************************************************************************/
+void LLWU_IRQHandler(void){
+    if(((LLWU->PF1 & SLEEP_KEY_PF1) != 0) || ((LLWU->PF2 & SLEEP_KEY_PF2) != 0)){
+        sleepKeyWake = TRUE;
+    }else{
+    }
+    LLWU->PF1 = SLEEP_KEY_PF1;
+    LLWU->PF2 = SLEEP_KEY_PF2;
+}
+
+/********************************************************************************
+ *   sleepRtcTicks: RTC time in 1/32768s, wraps after 36 hours. TSR is read
+ *                  again so a carry between the two registers is not missed.
+ ********************************************************************************/
+static INT32U sleepRtcTicks(void){
+    INT32U sec;
+    INT32U pre;
+    do{
+        sec = RTC->TSR;
+        pre = RTC->TPR & SLEEP_RTC_TPR_MASK;
+    }while(sec != RTC->TSR);
+    return (sec*SLEEP_RTC_HZ) + pre;
+}
+
+/********************************************************************************
+ *   sleepTicksToUs: RTC ticks to us
+ ********************************************************************************/
+static INT32U sleepTicksToUs(INT32U ticks){
+    return (INT32U)((((INT64U)ticks)*1000000U)/SLEEP_RTC_HZ);
+}
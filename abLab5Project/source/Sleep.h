@@ -0,0 +1,34 @@
+/********************************************************************************
+ * Sleep.h - Low-leakage stop (LLS) while the panel is idle, woken by the
+ *           LLWU from a keypad column edge or a TSI monitor touch.
+ *           Only the keypad and the pads wake it, not UART2. Received bytes
+ *           are lost and a stream stops while asleep, so the application must
+ *           not call SleepEnter() while a UART2 stream is on or the shell is
+ *           in use.
+ * 10/18/2026
+ ********************************************************************************/
+#ifndef SLEEP_H_
+#define SLEEP_H_
+
+/* SleepEnter() return, wake-up source bits */
+#define SLEEP_WAKE_NONE   0x00U     // Not entered, see SleepEnter()
+#define SLEEP_WAKE_KEY    0x01U
+#define SLEEP_WAKE_TSI    0x02U
+
+/* Totals since SleepInit(), see SleepGetStats() */
+typedef struct{
+    INT32U entries;         // SleepEnter() calls that stopped
+    INT32U key_wakes;
+    INT32U tsi_wakes;
+    INT32U slept_ms;        // Time from stop to wake-up, by the RTC
+    INT32U awake_us;        // Of that, core running between monitor scans
+    INT32U latency_us;      // Last wake-up to SleepResponse()
+    INT32U latency_max_us;
+}SLEEP_STATS_T;
+
+void SleepInit(INT16U tsi_chmask);
+INT8U SleepEnter(void);
+void SleepResponse(void);
+void SleepGetStats(SLEEP_STATS_T *const stats);
+
+#endif /* SLEEP_H_ */
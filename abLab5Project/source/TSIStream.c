@@ -0,0 +1,96 @@
+/********************************************************************************
+ * TSIStream.c - Sends a frame for every TSI scan over UART2 so the raw counts,
+ *               baselines and thresholds of all scanned electrodes can be
+ *               recorded while the pads are touched. The scans are queued by
+ *               the TSI module and the frames by BIOWriteBlock(), so a slow
+ *               link drops frames instead of holding up any task.
+ * 10/18/2026
+ ********************************************************************************/
+#include "MCUType.h"
+#include "BasicIO.h"
+#include "K65TWR_TSI.h"
+#include "TSIStream.h"
+
+/********************************************************************************
+ * Private Resources
+ ********************************************************************************/
+#define TSI_STREAM_MAX_FRAMES 16U   // Per call, bounds the task time
+static INT8U tsiStreamFrame[TSI_STREAM_FRAME_SIZE];
+static INT8U tsiStreamPending = FALSE;  // tsiStreamFrame[] waiting for room
+static INT8U tsiStreamNextSeq = 0;
+static INT32U tsiStreamDropped = 0;
+static void tsiStreamBuild(const TSI_TELEM_T *const rec);
+
+/********************************************************************************
+ *   TSIStreamInit: Starts the TSI telemetry records. BIOOpen() and TSIInit()
+ *                  must have been called.
+ ********************************************************************************/
+void TSIStreamInit(void){
+    tsiStreamPending = FALSE;
+    tsiStreamNextSeq = 0;
+    tsiStreamDropped = 0;
+    TSITelemEnable(TRUE);
+}
+
+/********************************************************************************
+ *   TSIStreamTask: Cooperative task, call once per slice. Frames the waiting
+ *                  records and queues them for the UART until the queue is
+ *                  full. A frame that does not fit is kept for the next call.
+ ********************************************************************************/
+void TSIStreamTask(void){
+    TSI_TELEM_T rec;
+    INT8U nframes = 0;
+    INT8U more = TRUE;
+    while((more == TRUE) && (nframes < TSI_STREAM_MAX_FRAMES)){
+        if(tsiStreamPending == FALSE){
+            if(TSITelemGet(&rec) == TRUE){
+                tsiStreamBuild(&rec);
+                tsiStreamPending = TRUE;
+            }else{
+                more = FALSE;
+            }
+        }else{
+        }
+        if(tsiStreamPending == TRUE){
+            if(BIOWriteBlock(tsiStreamFrame, TSI_STREAM_FRAME_SIZE) == TRUE){
+                tsiStreamPending = FALSE;
+                nframes++;
+            }else{
+                more = FALSE;               //UART busy, try next slice
+            }
+        }else{
+        }
+    }
+}
+
+/********************************************************************************
+ *   TSIStreamGetDropped: Returns the number of scans lost because the
+ *                        records were not read in time.
+ ********************************************************************************/
+INT32U TSIStreamGetDropped(void){
+    return tsiStreamDropped;
+}
+
+/********************************************************************************
+ *   tsiStreamBuild: Packs a record into tsiStreamFrame[] and counts the
+ *                   records skipped since the last one.
+ ********************************************************************************/
+static void tsiStreamBuild(const TSI_TELEM_T *const rec){
+    INT8U i;
+    INT8U sum = 0;
+    tsiStreamDropped += (INT8U)(rec->seq - tsiStreamNextSeq);
+    tsiStreamNextSeq = (INT8U)(rec->seq + 1U);
+    tsiStreamFrame[0] = TSI_STREAM_SYNC;
+    tsiStreamFrame[1] = rec->seq;
+    tsiStreamFrame[2] = rec->channel;
+    tsiStreamFrame[3] = (INT8U)rec->count;
+    tsiStreamFrame[4] = (INT8U)(rec->count>>8);
+    tsiStreamFrame[5] = (INT8U)rec->baseline;
+    tsiStreamFrame[6] = (INT8U)(rec->baseline>>8);
+    tsiStreamFrame[7] = (INT8U)rec->threshold;
+    tsiStreamFrame[8] = (INT8U)(rec->threshold>>8);
+    for(i = 1; i < (TSI_STREAM_FRAME_SIZE - 1U); i++){
+        sum += tsiStreamFrame[i];
+    }
+    tsiStreamFrame[TSI_STREAM_FRAME_SIZE - 1U] = (INT8U)(0U - sum);
+}
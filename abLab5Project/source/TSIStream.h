@@ -0,0 +1,21 @@
+/********************************************************************************
+ * TSIStream.h - Streams TSI telemetry over UART2 for tuning the touch offsets.
+ * 10/18/2026
+ ********************************************************************************/
+#ifndef TSISTREAM_H_
+#define TSISTREAM_H_
+
+/* Frame, 10 bytes, 16-bit values little endian:
+ *   [0] TSI_STREAM_SYNC
+ *   [1] seq, +1 per scan, a gap is that many dropped scans
+ *   [2] channel, bit 7 (TSI_TELEM_TOUCHED) set while touched
+ *   [3:4] raw count  [5:6] baseline  [7:8] touch threshold
+ *   [9] check, bytes 1-9 sum to zero mod 256 */
+#define TSI_STREAM_SYNC       0xA5U
+#define TSI_STREAM_FRAME_SIZE 10U
+
+void TSIStreamInit(void);
+void TSIStreamTask(void);
+INT32U TSIStreamGetDropped(void);
+
+#endif /* TSISTREAM_H_ */
@@ -0,0 +1,182 @@
+/********************************************************************************
+ * Telemetry.c - Sends a snapshot of the system state every period. Each
+ *               snapshot is packed little endian, followed by a CRC-16 and
+ *               COBS encoded, so a 0x00 only ever marks the end of a packet
+ *               and a receiver can resync on any byte. The packet is sent by
+ *               DMA from its buffer with BIOWriteDesc(). If the previous
+ *               packet is still going out the snapshot is skipped and
+ *               counted, nothing waits for the UART.
+ * 10/18/2026
+ ********************************************************************************/
+#include "MCUType.h"
+#include "BasicIO.h"
+#include "SysTickDelay.h"
+#include "Telemetry.h"
+
+/********************************************************************************
+ * Private Resources
+ ********************************************************************************/
+#define TELEM_CRC_INIT      0xFFFFU
+#define TELEM_RAW_SIZE      (TELEM_SNAP_SIZE + 2U)          // With the CRC
+#define TELEM_PKT_SIZE      (TELEM_RAW_SIZE + 2U)           // COBS code and 0x00
+static INT8U telemRaw[TELEM_RAW_SIZE];
+static INT8U telemPkt[TELEM_PKT_SIZE];
+static BIO_DESC_T telemDesc;
+static volatile INT8U telemBusy = FALSE;    // telemPkt[] owned by BasicIO
+static INT16U telemPeriod;
+static INT32U telemLastMs;
+static INT8U telemSeq;
+static INT32U telemSkipped;
+static INT8U telemOn;
+static void telemDone(BIO_DESC_T *const desc);
+static INT16U telemCrc16(const INT8U *data, INT16U len);
+static INT16U telemCobs(const INT8U *src, INT16U len, INT8U *dst);
+static INT8U telemPut16(INT8U idx, INT16U value);
+static INT8U telemPut32(INT8U idx, INT32U value);
+static const INT16U telemCrcNibble[16] = {
+    0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+    0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU
+};
+
+/********************************************************************************
+ *   TelemInit: Starts the snapshots. BIOOpen() must have been called.
+ *              period_ms - time between snapshots, a multiple of the slice
+ ********************************************************************************/
+void TelemInit(INT16U period_ms){
+    telemPeriod = period_ms;
+    telemLastMs = SysTickGetmsCount();
+    telemSeq = 0;
+    telemSkipped = 0;
+    telemBusy = FALSE;
+    telemOn = TRUE;
+    telemDesc.buf = telemPkt;
+    telemDesc.done = telemDone;
+}
+
+/********************************************************************************
+ *   TelemTask: Cooperative task, call once per slice. When a period has
+ *              passed it builds the snapshot and queues the packet.
+ *              app - the application part of the snapshot
+ ********************************************************************************/
+void TelemTask(const TELEM_APP_T *const app){
+    INT32U now;
+    INT8U idx;
+    INT16U crc;
+    SYSTICK_STATS_T slice;
+    now = SysTickGetmsCount();
+    if((telemOn == TRUE) && ((now - telemLastMs) >= telemPeriod)){
+        telemLastMs = now;
+        if(telemBusy == FALSE){
+            SysTickGetSliceStats(&slice);
+            telemRaw[0] = TELEM_TYPE_SNAP;
+            telemRaw[1] = telemSeq;
+            idx = telemPut32(2U, now);
+            telemRaw[idx] = app->alarm_state;
+            idx = telemPut16((INT8U)(idx + 1U), app->tsi_flags);
+            telemRaw[idx] = (INT8U)app->last_key;
+            idx = telemPut16((INT8U)(idx + 1U), app->key_presses);
+            idx = telemPut16(idx, (INT16U)slice.busy_us);
+            idx = telemPut16(idx, (INT16U)slice.busy_max_us);
+            idx = telemPut16(idx, (INT16U)slice.overruns);
+            idx = telemPut16(idx, app->checksum);
+            crc = telemCrc16(telemRaw, idx);
+            (void)telemPut16(idx, crc);
+            telemDesc.len = telemCobs(telemRaw, TELEM_RAW_SIZE, telemPkt);
+            telemBusy = TRUE;
+            if(BIOWriteDesc(&telemDesc) == FALSE){
+                telemBusy = FALSE;
+                telemSkipped++;
+            }else{
+            }
+        }else{
+            telemSkipped++;
+        }
+        telemSeq++;
+    }else{
+    }
+}
+
+/********************************************************************************
+ *   TelemEnable: Stops or restarts the snapshots, e.g. while a person uses
+ *                the shell on the same UART. TelemInit() starts them.
+ *                enable - TRUE or FALSE
+ ********************************************************************************/
+void TelemEnable(INT8U enable){
+    telemOn = enable;
+}
+
+/********************************************************************************
+ *   TelemIsOn: Returns TRUE while the snapshots are being sent.
+ ********************************************************************************/
+INT8U TelemIsOn(void){
+    return telemOn;
+}
+
+/********************************************************************************
+ *   TelemGetSkipped: Returns the number of snapshots not sent because the
+ *                    previous packet was still going out.
+ ********************************************************************************/
+INT32U TelemGetSkipped(void){
+    return telemSkipped;
+}
+
+/********************************************************************************
+ *   telemDone: BIOWriteDesc() completion, from the DMA interrupt.
+ ********************************************************************************/
+static void telemDone(BIO_DESC_T *const desc){
+    telemBusy = FALSE;
+}
+
+/********************************************************************************
+ *   telemPut16, telemPut32: Store a value little endian in telemRaw[] at idx.
+ *                           Return the index after it.
+ ********************************************************************************/
+static INT8U telemPut16(INT8U idx, INT16U value){
+    telemRaw[idx] = (INT8U)value;
+    telemRaw[idx + 1U] = (INT8U)(value>>8);
+    return (INT8U)(idx + 2U);
+}
+
+static INT8U telemPut32(INT8U idx, INT32U value){
+    idx = telemPut16(idx, (INT16U)value);
+    return telemPut16(idx, (INT16U)(value>>16));
+}
+
+/********************************************************************************
+ *   telemCrc16: CRC-16/CCITT-FALSE, a nibble at a time from a 16 entry table.
+ ********************************************************************************/
+static INT16U telemCrc16(const INT8U *data, INT16U len){
+    INT16U crc = TELEM_CRC_INIT;
+    INT16U i;
+    for(i = 0; i < len; i++){
+        crc = (INT16U)((crc<<4) ^ telemCrcNibble[(crc>>12) ^ (data[i]>>4)]);
+        crc = (INT16U)((crc<<4) ^ telemCrcNibble[(crc>>12) ^ (data[i] & 0x0FU)]);
+    }
+    return crc;
+}
+
+/********************************************************************************
+ *   telemCobs: COBS encodes len bytes (len < 254) from src into dst and adds
+ *              the 0x00 delimiter. Returns the number of bytes in dst.
+ ********************************************************************************/
+static INT16U telemCobs(const INT8U *src, INT16U len, INT8U *dst){
+    INT16U code_idx = 0;        // Where the current block's code byte goes
+    INT16U out = 1;
+    INT8U code = 1;
+    INT16U i;
+    for(i = 0; i < len; i++){
+        if(src[i] == 0){
+            dst[code_idx] = code;
+            code_idx = out;
+            out++;
+            code = 1;
+        }else{
+            dst[out] = src[i];
+            out++;
+            code++;
+        }
+    }
+    dst[code_idx] = code;
+    dst[out] = 0;
+    return (INT16U)(out + 1U);
+}
@@ -0,0 +1,36 @@
+/********************************************************************************
+ * Telemetry.h - Periodic system state snapshot sent over UART2 as COBS framed
+ *               packets with a CRC trailer.
+ * 10/18/2026
+ ********************************************************************************/
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/* Packet on the wire: COBS(payload, crc) then a 0x00 delimiter. The CRC is
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of the payload, little endian.
+ * Payload, TELEM_SNAP_SIZE bytes, little endian:
+ *   [0] TELEM_TYPE_SNAP       [1] seq, +1 per packet, gaps are skipped packets
+ *   [2:5] uptime ms           [6] alarm state
+ *   [7:8] TSI flags           [9] last key code, 0 if none yet
+ *   [10:11] key presses       [12:13] last slice busy us
+ *   [14:15] max slice busy us [16:17] slice overruns
+ *   [18:19] program checksum */
+#define TELEM_TYPE_SNAP   0x01U
+#define TELEM_SNAP_SIZE   20U
+
+/* Application state for the snapshot, the rest is gathered by the module */
+typedef struct{
+    INT8U alarm_state;
+    INT16U tsi_flags;
+    INT8C last_key;
+    INT16U key_presses;
+    INT16U checksum;
+}TELEM_APP_T;
+
+void TelemInit(INT16U period_ms);
+void TelemTask(const TELEM_APP_T *const app);
+void TelemEnable(INT8U enable);
+INT8U TelemIsOn(void);
+INT32U TelemGetSkipped(void);
+
+#endif /* TELEMETRY_H_ */
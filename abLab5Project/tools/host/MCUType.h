@@ -0,0 +1,112 @@
+/**********************************************************************************
+* MCUType.h - Host stand-in for source/MCUType.h so board modules can be built and
+*             run on a PC by the programs in tools/host. The types have the same
+*             widths as on the K65, so INT32U is 32 bits here too.
+*             Put this directory first in the include path.
+*
+* 10/18/2026 Initial version, for fmt_bench.c
+* 10/18/2026 Added the peripherals LCD.c uses, modelled by lcd_model.c
+**********************************************************************************/
+#ifndef  MCU_TYPE_PRESENT
+#define  MCU_TYPE_PRESENT
+
+#include <stdint.h>
+
+/**********************************************************************************
+* Standard WWU type definitions
+**********************************************************************************/
+typedef char                INT8C;
+typedef uint8_t             INT8U;
+typedef int8_t              INT8S;
+typedef uint16_t            INT16U;
+typedef int16_t             INT16S;
+typedef uint32_t            INT32U;
+typedef int32_t             INT32S;
+typedef uint64_t            INT64U;
+typedef int64_t             INT64S;
+typedef float               FP32;
+typedef double              FP64;
+
+/**********************************************************************************
+* General Defined Constants
+**********************************************************************************/
+#define FALSE    0
+#define TRUE     1
+
+/**********************************************************************************
+* Peripheral stand-ins. Each peripheral name is a call to its model in lcd_model.c,
+* so every register access is seen in order and takes virtual time. Only the
+* registers and fields LCD.c uses are here, with the K65 bit positions.
+**********************************************************************************/
+typedef struct{
+    volatile INT32U PDOR;
+    volatile INT32U PSOR;
+    volatile INT32U PCOR;
+    volatile INT32U PTOR;
+    volatile INT32U PDIR;
+    volatile INT32U PDDR;
+}GPIO_Type;
+
+typedef struct{
+    volatile INT32U PCR[32];
+}PORT_Type;
+
+typedef struct{
+    volatile INT32U SCGC5;
+    volatile INT32U SCGC6;
+    volatile INT32U SCGC7;
+}SIM_Type;
+
+typedef struct{
+    volatile INT32U LDVAL;
+    volatile INT32U CVAL;
+    volatile INT32U TCTRL;
+    volatile INT32U TFLG;
+}PIT_CHANNEL_Type;
+
+typedef struct{
+    volatile INT32U MCR;
+    PIT_CHANNEL_Type CHANNEL[4];
+}PIT_Type;
+
+typedef struct{
+    volatile INT32U CTRL;
+    volatile INT32U CYCCNT;
+}DWT_Type;
+
+typedef struct{
+    volatile INT32U DEMCR;
+}CoreDebug_Type;
+
+typedef enum{
+    PIT1_IRQn = 49
+}IRQn_Type;
+
+GPIO_Type *HostGpiod(void);
+PORT_Type *HostPortd(void);
+SIM_Type *HostSim(void);
+PIT_Type *HostPit(void);
+DWT_Type *HostDwt(void);
+CoreDebug_Type *HostCoreDebug(void);
+void NVIC_SetPriority(IRQn_Type irq, INT32U priority);
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_SetPendingIRQ(IRQn_Type irq);
+
+#define GPIOD      (HostGpiod())
+#define PORTD      (HostPortd())
+#define SIM        (HostSim())
+#define PIT        (HostPit())
+#define DWT        (HostDwt())
+#define CoreDebug  (HostCoreDebug())
+
+#define SIM_SCGC5_PORTD(x)          (((INT32U)(x) << 12) & 0x1000U)
+#define SIM_SCGC6_PIT(x)            (((INT32U)(x) << 23) & 0x800000U)
+#define PORT_PCR_MUX(x)             (((INT32U)(x) << 8) & 0x700U)
+#define PIT_MCR_MDIS(x)             (((INT32U)(x) << 1) & 0x2U)
+#define PIT_TCTRL_TEN(x)            ((INT32U)(x) & 0x1U)
+#define PIT_TCTRL_TIE(x)            (((INT32U)(x) << 1) & 0x2U)
+#define PIT_TFLG_TIF(x)             ((INT32U)(x) & 0x1U)
+#define DWT_CTRL_CYCCNTENA_Msk      0x1U
+#define CoreDebug_DEMCR_TRCENA_Msk  0x1000000U
+
+#endif
@@ -0,0 +1,220 @@
+/*****************************************************************************************
+* fmt_bench.c - Host benchmark of board/StrFmt.c FmtDecWord() against the digit loop it
+*               replaced in LcdDispDecWord() and BIOOutDecWord(), which did a 32-bit % 10
+*               and / 10 per digit. Every value is also checked for the same output in
+*               all three modes, so the benchmark doubles as a regression test.
+*
+*   Build and run from abLab5Project:
+*     gcc -O2 -std=gnu99 -Itools/host -Iboard tools/host/fmt_bench.c board/StrFmt.c \
+*         -o fmt_bench && ./fmt_bench
+*
+*   Cycles are the x86 time stamp counter, ns elsewhere. A host CPU divides by a
+*   constant with a multiply as well, so the ratio on the K65, where UDIV takes up to
+*   12 cycles and the reciprocal is one UMULL, is larger than shown here. Measure the
+*   target with the DWT cycle counter the same way for absolute numbers.
+* 10/18/2026
+*****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+#define BENCH_NOW() ((INT64U)__rdtsc())
+#else
+#define BENCH_UNIT "ns"
+static INT64U benchNs(void);
+#define BENCH_NOW() benchNs()
+#endif
+#include "MCUType.h"
+#include "StrFmt.h"
+
+#define BENCH_NUM_VALUES 4096U
+#define BENCH_REPEAT     200U
+#define BENCH_FIELD      10U
+
+static INT32U benchValues[BENCH_NUM_VALUES];
+static volatile INT8C benchSink;
+
+static void oldDecWord(INT8C *const digitstrg, INT32U binword, INT8U field,
+                       FMT_DEC_MODE mode);
+static void benchFillValues(void);
+static INT32U benchCheck(void);
+static FP64 benchRun(INT8U use_new, FMT_DEC_MODE mode);
+
+/*****************************************************************************************
+* oldDecWord() - The pre-StrFmt digit loop, as it was in BIOOutDecWord(), with the
+*                BIOPutStrg() calls taken out so it only builds the string.
+*****************************************************************************************/
+static void oldDecWord(INT8C *const digitstrg, INT32U binword, INT8U field,
+                       FMT_DEC_MODE mode){
+    INT32U lbinword = binword;
+    INT8U num_digits = field;
+    INT8U digit_index;
+    INT8U val_index;
+
+    if(num_digits > 10){
+        num_digits = 10;
+    }else if(num_digits < 1){
+        num_digits = 1;
+    }else{
+    }
+    digit_index = num_digits;
+    digitstrg[digit_index] = '\0';
+    while((digit_index > 0) && (lbinword > 0)){
+        digit_index--;
+        digitstrg[digit_index] = (INT8C)((lbinword % 10) +'0');
+        lbinword = lbinword/10;
+    }
+    if(digit_index == num_digits){
+        digit_index--;
+        digitstrg[digit_index] = '0';
+    }else{
+    }
+    if(lbinword > 0){
+        digit_index = 0;
+        while(digit_index < num_digits){
+            digitstrg[digit_index] = '-';
+            digit_index++;
+        }
+        digitstrg[digit_index] = '\0';
+    }else{
+        if((mode == FMT_DEC_MODE_AR) || (mode == FMT_DEC_MODE_LZ)){
+            while(digit_index > 0){
+                digit_index--;
+                if(mode == FMT_DEC_MODE_AR){
+                    digitstrg[digit_index] = ' ';
+                }else{
+                    digitstrg[digit_index] = '0';
+                }
+            }
+        }else{
+            val_index = digit_index;
+            digit_index = 0;
+            while(val_index < num_digits){
+                digitstrg[digit_index] = digitstrg[val_index];
+                val_index++;
+                digit_index++;
+            }
+            while(digit_index < num_digits){
+                digitstrg[digit_index] = ' ';
+                digit_index++;
+            }
+            digitstrg[digit_index] = '\0';
+        }
+    }
+}
+
+/*****************************************************************************************
+* benchFillValues() - Pseudo random words spread evenly over 1 to 10 digits, plus the
+*                     edge cases.
+*****************************************************************************************/
+static void benchFillValues(void){
+    INT32U x = 0x2545F491U;
+    INT32U i;
+    for(i = 0; i < BENCH_NUM_VALUES; i++){
+        x ^= x << 13;                       /* xorshift32 */
+        x ^= x >> 17;
+        x ^= x << 5;
+        benchValues[i] = x >> (i % 32U);
+    }
+    benchValues[0] = 0U;
+    benchValues[1] = 9U;
+    benchValues[2] = 10U;
+    benchValues[3] = 99U;
+    benchValues[4] = 100U;
+    benchValues[5] = 999999999U;
+    benchValues[6] = 1000000000U;
+    benchValues[7] = 0xFFFFFFFFU;
+}
+
+/*****************************************************************************************
+* benchCheck() - Compares old and new output for every value, mode and field size.
+*                Returns the number of mismatches.
+*****************************************************************************************/
+static INT32U benchCheck(void){
+    INT8C old_strg[BENCH_FIELD + 1U];
+    INT8C new_strg[BENCH_FIELD + 1U];
+    INT32U i;
+    INT32U errors = 0;
+    INT8U field;
+    INT8U mode;
+    for(i = 0; i < BENCH_NUM_VALUES; i++){
+        for(field = 1; field <= BENCH_FIELD; field++){
+            for(mode = FMT_DEC_MODE_LZ; mode <= FMT_DEC_MODE_AL; mode++){
+                oldDecWord(old_strg, benchValues[i], field, (FMT_DEC_MODE)mode);
+                (void)FmtDecWord(new_strg, benchValues[i], field, (FMT_DEC_MODE)mode);
+                if(strcmp(old_strg, new_strg) != 0){
+                    if(errors < 10U){
+                        printf("mismatch %lu field %u mode %u: old '%s' new '%s'\n",
+                               (unsigned long)benchValues[i], field, mode, old_strg,
+                               new_strg);
+                    }else{
+                    }
+                    errors++;
+                }else{
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+/*****************************************************************************************
+* benchRun() - Returns the average time per conversion, best of BENCH_REPEAT passes over
+*              benchValues[] so interrupts and frequency changes are filtered out.
+*****************************************************************************************/
+static FP64 benchRun(INT8U use_new, FMT_DEC_MODE mode){
+    INT8C strg[BENCH_FIELD + 1U];
+    INT64U best = ~(INT64U)0;
+    INT64U start;
+    INT64U ticks;
+    INT32U rep;
+    INT32U i;
+    for(rep = 0; rep < BENCH_REPEAT; rep++){
+        start = BENCH_NOW();
+        for(i = 0; i < BENCH_NUM_VALUES; i++){
+            if(use_new == TRUE){
+                (void)FmtDecWord(strg, benchValues[i], BENCH_FIELD, mode);
+            }else{
+                oldDecWord(strg, benchValues[i], BENCH_FIELD, mode);
+            }
+            benchSink = strg[BENCH_FIELD - 1U];
+        }
+        ticks = BENCH_NOW() - start;
+        if(ticks < best){
+            best = ticks;
+        }else{
+        }
+    }
+    return (FP64)best/BENCH_NUM_VALUES;
+}
+
+#if !(defined(__x86_64__) || defined(__i386__))
+static INT64U benchNs(void){
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((INT64U)ts.tv_sec*1000000000U) + (INT64U)ts.tv_nsec;
+}
+#endif
+
+int main(void){
+    static const char *const mode_names[] = {"LZ", "AR", "AL"};
+    INT32U errors;
+    INT8U mode;
+    FP64 old_t;
+    FP64 new_t;
+
+    benchFillValues();
+    errors = benchCheck();
+    printf("FmtDecWord() vs old digit loop, %u values, field %u, %s per conversion\n",
+           BENCH_NUM_VALUES, BENCH_FIELD, BENCH_UNIT);
+    for(mode = FMT_DEC_MODE_LZ; mode <= FMT_DEC_MODE_AL; mode++){
+        old_t = benchRun(FALSE, (FMT_DEC_MODE)mode);
+        new_t = benchRun(TRUE, (FMT_DEC_MODE)mode);
+        printf("  %s  old %7.1f  new %7.1f  %.2fx\n", mode_names[mode], old_t, new_t,
+               old_t/new_t);
+    }
+    printf("output mismatches: %lu\n", (unsigned long)errors);
+    return (errors == 0U) ? 0 : 1;
+}
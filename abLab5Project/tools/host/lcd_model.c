@@ -0,0 +1,712 @@
+/*****************************************************************************************
+* lcd_model.c - Host HD44780 model for board/LCD.c. LCD.c is built unchanged against the
+*               peripheral stand-ins in tools/host/MCUType.h. The RS, E and DB4-DB7 writes
+*               it makes to GPIOD are decoded into HD44780 instructions, which update a
+*               model of the panel's DDRAM, CGRAM and address counter. Every E pulse and
+*               instruction is checked against the datasheet minimums in virtual time.
+*               Each API call in the test below reports its instructions and bus time.
+*
+*   Build and run from abLab5Project:
+*     gcc -std=gnu99 -Itools/host -Iboard tools/host/lcd_model.c board/LCD.c \
+*         board/StrFmt.c -o lcd_model && ./lcd_model
+*   Exits non-zero on a timing violation or a panel that does not show what was written.
+*
+*   Virtual time: code between register accesses takes no time, the worst case for the
+*   checks. Each GPIOD, PIT, SIM or PORTD access takes one bus clock and each DWT read
+*   one core clock. A write takes effect at the end of its access. PIT1 counts down at
+*   the bus clock and NVIC_SetPendingIRQ() runs PIT1_IRQHandler() at once, as the
+*   interrupt would preempt the task.
+*
+*   Timing (HD44780U datasheet, VCC = 4.5-5.5V, write):
+*     tcycE 500ns, PWEH 230ns, tAS 40ns, tAH 10ns, tDSW 80ns, tH 10ns
+*     15ms power up, 4.1ms and 100us after the first two reset nibbles,
+*     1.52ms clear and home, 37us everything else
+* 10/18/2026
+*****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "MCUType.h"
+#include "LCD.h"
+
+/*****************************************************************************************
+* Model Resources
+*****************************************************************************************/
+#define MODEL_RS_BIT        0x2U            /* PTD1, as LCD.c */
+#define MODEL_E_BIT         0x4U            /* PTD2 */
+#define MODEL_DB_SHIFT      3U              /* DB4-DB7 on PTD3-PTD6 */
+#define MODEL_DB_MASK       0x78U
+
+#define MODEL_T_CYCE_NS     500.0
+#define MODEL_T_PWEH_NS     230.0
+#define MODEL_T_AS_NS       40.0
+#define MODEL_T_AH_NS       10.0
+#define MODEL_T_DSW_NS      80.0
+#define MODEL_T_H_NS        10.0
+#define MODEL_T_POWER_NS    15000000.0
+#define MODEL_T_RESET1_NS   4100000.0
+#define MODEL_T_RESET2_NS   100000.0
+#define MODEL_T_CLEAR_NS    1520000.0
+#define MODEL_T_EXEC_NS     37000.0
+
+#define MODEL_DDRAM_SIZE    0x80U
+#define MODEL_CGRAM_SIZE    0x40U
+#define MODEL_LINE2_ADDR    0x40U
+#define MODEL_LINE_LEN      0x28U           /* DDRAM per line in 2-line mode */
+#define MODEL_COLS          16U
+#define MODEL_ROWS          2U
+#define MODEL_MAX_REPORTS   20U
+
+#define MODEL_PIT_CH        1U
+#define MODEL_FEI_HZ        20971520.0
+
+/* Peripheral state behind the stand-ins */
+static GPIO_Type modelGpiod;
+static PORT_Type modelPortd;
+static SIM_Type modelSim;
+static PIT_Type modelPit;
+static DWT_Type modelDwt;
+static CoreDebug_Type modelCoreDebug;
+
+/* Virtual time and clocks */
+static FP64 modelNowNs;
+static FP64 modelCyc;                       /* Core cycles, low 32 bits are CYCCNT */
+static FP64 modelCoreHz;
+static FP64 modelBusHz;
+
+/* PIT1 */
+static INT32U modelPitTctrl;                /* Last TCTRL seen, for TEN edges */
+static INT8U modelPitRunning;
+static FP64 modelPitLeft;                   /* Counts to the next expiry */
+static INT8U modelInIsr;
+
+/* Pins and their last change */
+static INT32U modelPins;
+static FP64 modelRsNs;
+static FP64 modelDbNs;
+static FP64 modelERiseNs;
+static FP64 modelEFallNs;
+
+/* HD44780 */
+static INT8U modelBits8;                    /* 8-bit interface, as after power up */
+static INT8U modelResetNibs;                /* Function set nibbles seen in 8-bit mode */
+static INT8U modelHaveHigh;                 /* First nibble of a byte latched */
+static INT8U modelHigh;
+static FP64 modelInstrNs;                   /* Last instruction latched */
+static FP64 modelBusyUntil;
+static INT8U modelDdram[MODEL_DDRAM_SIZE];
+static INT8U modelCgram[MODEL_CGRAM_SIZE];
+static INT8U modelAc;
+static INT8U modelAcCg;                     /* Address counter is in CGRAM */
+static INT8U modelIncr;
+static INT8U modelTwoLine;
+static INT8U modelDispOn;
+
+/* Counts */
+static INT32U modelViolations;
+static INT32U modelInstrs;
+static INT32U modelEPulses;
+static INT32U modelPanelErrors;
+
+static void modelAccess(FP64 hz);
+static void modelSync(void);
+static void modelSyncPit(void);
+static void modelPitAdvance(FP64 ns);
+static void modelPinsChanged(INT32U pins);
+static void modelLatch(INT8U rs, INT8U nib);
+static void modelExec(INT8U rs, INT8U byte);
+static void modelAcStep(INT8S dir);
+static void modelViolation(const char *what, FP64 got, FP64 min);
+static void modelRun(FP64 ns);
+static void modelRunIdle(void);
+static void modelSetClocks(FP64 core_hz, FP64 bus_hz);
+static void modelPowerUp(void);
+static void modelCheckPanel(const char *line1, const char *line2);
+static void modelCheckGlyph(INT8C code, const INT8U *pattern);
+static void modelMeasureStart(void);
+static void modelMeasureEnd(const char *name);
+
+void PIT1_IRQHandler(void);
+
+/*****************************************************************************************
+* Peripheral stand-ins, see tools/host/MCUType.h. Pending register writes are applied
+* first, then the access takes its time.
+*****************************************************************************************/
+GPIO_Type *HostGpiod(void){
+    modelSync();
+    modelAccess(modelBusHz);
+    return &modelGpiod;
+}
+
+PORT_Type *HostPortd(void){
+    modelSync();
+    modelAccess(modelBusHz);
+    return &modelPortd;
+}
+
+SIM_Type *HostSim(void){
+    modelSync();
+    modelAccess(modelBusHz);
+    return &modelSim;
+}
+
+PIT_Type *HostPit(void){
+    modelSync();
+    modelAccess(modelBusHz);
+    modelPit.CHANNEL[MODEL_PIT_CH].CVAL = (INT32U)modelPitLeft;
+    return &modelPit;
+}
+
+DWT_Type *HostDwt(void){
+    modelSync();
+    modelAccess(modelCoreHz);
+    modelDwt.CYCCNT = (INT32U)(INT64U)modelCyc;
+    return &modelDwt;
+}
+
+CoreDebug_Type *HostCoreDebug(void){
+    modelSync();
+    modelAccess(modelCoreHz);
+    return &modelCoreDebug;
+}
+
+void NVIC_SetPriority(IRQn_Type irq, INT32U priority){
+    (void)irq;
+    (void)priority;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq){
+    (void)irq;
+}
+
+/* Interrupt preempts the task, so the handler runs now */
+void NVIC_SetPendingIRQ(IRQn_Type irq){
+    if((irq == PIT1_IRQn) && (modelInIsr == FALSE)){
+        modelSync();
+        modelInIsr = TRUE;
+        PIT1_IRQHandler();
+        modelInIsr = FALSE;
+        modelSync();
+    }else{
+    }
+}
+
+/*****************************************************************************************
+* modelAccess() - One clock of hz passes.
+*****************************************************************************************/
+static void modelAccess(FP64 hz){
+    FP64 ns = 1.0e9/hz;
+    modelPitAdvance(ns);
+    modelNowNs += ns;
+    modelCyc += (ns*modelCoreHz)/1.0e9;
+}
+
+/*****************************************************************************************
+* modelSync() - Applies the register writes made since the last access.
+*****************************************************************************************/
+static void modelSync(void){
+    INT32U pins = modelGpiod.PDOR;
+    pins |= modelGpiod.PSOR;
+    pins &= ~modelGpiod.PCOR;
+    pins ^= modelGpiod.PTOR;
+    modelGpiod.PSOR = 0;
+    modelGpiod.PCOR = 0;
+    modelGpiod.PTOR = 0;
+    modelGpiod.PDOR = pins;
+    if(pins != modelPins){
+        modelPinsChanged(pins);
+    }else{
+    }
+    modelSyncPit();
+}
+
+/*****************************************************************************************
+* modelSyncPit() - Starts or stops PIT1 on a TEN edge. Starting loads LDVAL + 1 counts.
+*****************************************************************************************/
+static void modelSyncPit(void){
+    INT32U tctrl = modelPit.CHANNEL[MODEL_PIT_CH].TCTRL;
+    if(((tctrl & PIT_TCTRL_TEN(1)) != 0) && ((modelPitTctrl & PIT_TCTRL_TEN(1)) == 0)){
+        modelPitRunning = TRUE;
+        modelPitLeft = (FP64)modelPit.CHANNEL[MODEL_PIT_CH].LDVAL + 1.0;
+    }else if((tctrl & PIT_TCTRL_TEN(1)) == 0){
+        modelPitRunning = FALSE;
+    }else{
+    }
+    modelPitTctrl = tctrl;
+}
+
+/*****************************************************************************************
+* modelPitAdvance() - Counts PIT1 down for ns at the bus clock. An expiry inside the
+*                     handler is only flagged, modelRun() takes the interrupt after it.
+*****************************************************************************************/
+static void modelPitAdvance(FP64 ns){
+    if(modelPitRunning == TRUE){
+        modelPitLeft -= (ns*modelBusHz)/1.0e9;
+        if(modelPitLeft <= 0.0){
+            modelPit.CHANNEL[MODEL_PIT_CH].TFLG = PIT_TFLG_TIF(1);
+        }else{
+        }
+    }else{
+    }
+}
+
+/*****************************************************************************************
+* modelPinsChanged() - Checks the setup and hold times of a pin change and latches a
+*                      nibble on the falling edge of E.
+*****************************************************************************************/
+static void modelPinsChanged(INT32U pins){
+    INT32U changed = pins ^ modelPins;
+    if((changed & MODEL_RS_BIT) != 0){
+        if((pins & MODEL_E_BIT) != 0){
+            modelViolation("RS changed with E high", 0.0, 0.0);
+        }else if(modelEPulses != 0){
+            modelViolation("tAH, RS hold after E", modelNowNs - modelEFallNs, MODEL_T_AH_NS);
+        }else{
+        }
+        modelRsNs = modelNowNs;
+    }else{
+    }
+    if((changed & MODEL_DB_MASK) != 0){
+        if(modelEPulses != 0){
+            modelViolation("tH, data hold after E", modelNowNs - modelEFallNs, MODEL_T_H_NS);
+        }else{
+        }
+        modelDbNs = modelNowNs;
+    }else{
+    }
+    if((changed & MODEL_E_BIT) != 0){
+        if((pins & MODEL_E_BIT) != 0){          /* Rising */
+            modelViolation("tAS, RS setup to E", modelNowNs - modelRsNs, MODEL_T_AS_NS);
+            if(modelEPulses != 0){
+                modelViolation("tcycE, E cycle", modelNowNs - modelERiseNs, MODEL_T_CYCE_NS);
+            }else{
+            }
+            if(modelHaveHigh == FALSE){
+                modelViolation("busy, next instruction after", modelNowNs - modelInstrNs,
+                               modelBusyUntil - modelInstrNs);
+            }else{
+            }
+            modelERiseNs = modelNowNs;
+        }else{                                  /* Falling, nibble latched */
+            modelViolation("PWEH, E pulse width", modelNowNs - modelERiseNs, MODEL_T_PWEH_NS);
+            modelViolation("tDSW, data setup to E fall", modelNowNs - modelDbNs,
+                           MODEL_T_DSW_NS);
+            modelEFallNs = modelNowNs;
+            modelEPulses++;
+            modelLatch(((pins & MODEL_RS_BIT) != 0) ? 1U : 0U,
+                       (INT8U)((pins & MODEL_DB_MASK) >> MODEL_DB_SHIFT));
+        }
+    }else{
+    }
+    modelPins = pins;
+}
+
+/*****************************************************************************************
+* modelLatch() - A nibble on DB4-DB7. In 8-bit mode it is a whole instruction with
+*                DB0-DB3 low, as wired. In 4-bit mode two make a byte.
+*****************************************************************************************/
+static void modelLatch(INT8U rs, INT8U nib){
+    if(modelBits8 == TRUE){
+        if((rs == 0) && ((nib & 0x0EU) == 0x02U)){   /* Function set */
+            modelResetNibs++;
+            modelInstrNs = modelNowNs;
+            if((nib & 0x01U) == 0){
+                modelBits8 = FALSE;
+                modelBusyUntil = modelNowNs + MODEL_T_EXEC_NS;
+            }else if(modelResetNibs == 1U){
+                modelBusyUntil = modelNowNs + MODEL_T_RESET1_NS;
+            }else if(modelResetNibs == 2U){
+                modelBusyUntil = modelNowNs + MODEL_T_RESET2_NS;
+            }else{
+                modelBusyUntil = modelNowNs + MODEL_T_EXEC_NS;
+            }
+            modelInstrs++;
+        }else{
+            modelViolation("not a function set before 4-bit mode", 0.0, 0.0);
+        }
+    }else if(modelHaveHigh == FALSE){
+        modelHigh = nib;
+        modelHaveHigh = TRUE;
+    }else{
+        modelHaveHigh = FALSE;
+        modelExec(rs, (INT8U)((modelHigh << 4) | nib));
+    }
+}
+
+/*****************************************************************************************
+* modelExec() - Runs one instruction or data write on the model panel.
+*****************************************************************************************/
+static void modelExec(INT8U rs, INT8U byte){
+    FP64 exec = MODEL_T_EXEC_NS;
+    modelInstrs++;
+    modelInstrNs = modelNowNs;
+    if(rs != 0){
+        if(modelAcCg == TRUE){
+            modelCgram[modelAc & (MODEL_CGRAM_SIZE - 1U)] = (INT8U)(byte & 0x1FU);
+        }else{
+            modelDdram[modelAc & (MODEL_DDRAM_SIZE - 1U)] = byte;
+        }
+        modelAcStep((modelIncr == TRUE) ? 1 : -1);
+    }else if(byte >= 0x80U){                    /* Set DDRAM address */
+        modelAc = (INT8U)(byte & 0x7FU);
+        modelAcCg = FALSE;
+        if((modelAc & (MODEL_LINE2_ADDR - 1U)) >= MODEL_LINE_LEN){
+            modelViolation("DDRAM address not on the display", 0.0, 0.0);
+        }else{
+        }
+    }else if(byte >= 0x40U){                    /* Set CGRAM address */
+        modelAc = (INT8U)(byte & 0x3FU);
+        modelAcCg = TRUE;
+    }else if(byte >= 0x20U){                    /* Function set */
+        if((byte & 0x10U) != 0){
+            modelViolation("function set back to 8-bit mode", 0.0, 0.0);
+        }else{
+        }
+        modelTwoLine = ((byte & 0x08U) != 0) ? TRUE : FALSE;
+    }else if(byte >= 0x10U){                    /* Cursor or display shift */
+        if((byte & 0x08U) == 0){
+            modelAcStep(((byte & 0x04U) != 0) ? 1 : -1);
+        }else{
+            modelViolation("display shift is not modelled", 0.0, 0.0);
+        }
+    }else if(byte >= 0x08U){                    /* Display on/off control */
+        modelDispOn = ((byte & 0x04U) != 0) ? TRUE : FALSE;
+    }else if(byte >= 0x04U){                    /* Entry mode set */
+        modelIncr = ((byte & 0x02U) != 0) ? TRUE : FALSE;
+        if((byte & 0x01U) != 0){
+            modelViolation("display shift is not modelled", 0.0, 0.0);
+        }else{
+        }
+    }else if(byte >= 0x02U){                    /* Return home */
+        modelAc = 0;
+        modelAcCg = FALSE;
+        exec = MODEL_T_CLEAR_NS;
+    }else{                                      /* Clear display */
+        memset(modelDdram, ' ', sizeof(modelDdram));
+        modelAc = 0;
+        modelAcCg = FALSE;
+        modelIncr = TRUE;
+        exec = MODEL_T_CLEAR_NS;
+    }
+    modelBusyUntil = modelNowNs + exec;
+}
+
+/*****************************************************************************************
+* modelAcStep() - Moves the address counter, line 1 wraps to line 2 in 2-line mode.
+*****************************************************************************************/
+static void modelAcStep(INT8S dir){
+    if(modelAcCg == TRUE){
+        modelAc = (INT8U)((modelAc + dir) & (MODEL_CGRAM_SIZE - 1U));
+    }else if(dir > 0){
+        if(modelAc == (MODEL_LINE_LEN - 1U)){
+            modelAc = MODEL_LINE2_ADDR;
+        }else if(modelAc == (MODEL_LINE2_ADDR + MODEL_LINE_LEN - 1U)){
+            modelAc = 0;
+        }else{
+            modelAc++;
+        }
+    }else{
+        if(modelAc == 0){
+            modelAc = MODEL_LINE2_ADDR + MODEL_LINE_LEN - 1U;
+        }else if(modelAc == MODEL_LINE2_ADDR){
+            modelAc = MODEL_LINE_LEN - 1U;
+        }else{
+            modelAc--;
+        }
+    }
+}
+
+/*****************************************************************************************
+* modelViolation() - Counts and reports a timing or protocol error. With min > 0 it is
+*                    only an error if got < min.
+*****************************************************************************************/
+static void modelViolation(const char *what, FP64 got, FP64 min){
+    if((min <= 0.0) || (got < min)){
+        if(modelViolations < MODEL_MAX_REPORTS){
+            if(min > 0.0){
+                printf("  VIOLATION at %.3fus: %s %.1fns < %.1fns\n", modelNowNs/1000.0, what,
+                       got, min);
+            }else{
+                printf("  VIOLATION at %.3fus: %s\n", modelNowNs/1000.0, what);
+            }
+        }else{
+        }
+        modelViolations++;
+    }else{
+    }
+}
+
+/*****************************************************************************************
+* modelRun() - Lets ns of virtual time pass with no task running, taking PIT1
+*              interrupts when they are due.
+*****************************************************************************************/
+static void modelRun(FP64 ns){
+    FP64 end = modelNowNs + ns;
+    FP64 due;
+    modelSync();
+    while(modelNowNs < end){
+        if((modelPitRunning == TRUE) && (modelPitLeft <= 0.0)){
+            modelPitLeft += (FP64)modelPit.CHANNEL[MODEL_PIT_CH].LDVAL + 1.0;
+            modelInIsr = TRUE;
+            PIT1_IRQHandler();
+            modelInIsr = FALSE;
+            modelSync();
+        }else if(modelPitRunning == TRUE){
+            due = modelNowNs + ((modelPitLeft*1.0e9)/modelBusHz);
+            if(due > end){
+                due = end;
+                modelPitAdvance(due - modelNowNs);
+            }else{
+                modelPitLeft = 0.0;                 /* Exact, no rounding left over */
+                modelPit.CHANNEL[MODEL_PIT_CH].TFLG = PIT_TFLG_TIF(1);
+            }
+            modelCyc += ((due - modelNowNs)*modelCoreHz)/1.0e9;
+            modelNowNs = due;
+        }else{
+            modelCyc += ((end - modelNowNs)*modelCoreHz)/1.0e9;
+            modelNowNs = end;
+        }
+    }
+}
+
+/*****************************************************************************************
+* modelRunIdle() - Runs until the operation queue is empty and PIT1 has stopped.
+*****************************************************************************************/
+static void modelRunIdle(void){
+    while(modelPitRunning == TRUE){
+        modelRun(1000.0);
+    }
+}
+
+/*****************************************************************************************
+* modelSetClocks() - A clock change. PIT1 keeps its count and counts on at the new bus
+*                    clock, as on the K65. LcdClkChange() is the caller's job.
+*****************************************************************************************/
+static void modelSetClocks(FP64 core_hz, FP64 bus_hz){
+    modelSync();
+    modelCoreHz = core_hz;
+    modelBusHz = bus_hz;
+}
+
+/*****************************************************************************************
+* modelPowerUp() - Power on reset of the panel and the model, at the K65TWR boot clocks.
+*****************************************************************************************/
+static void modelPowerUp(void){
+    modelNowNs = 0.0;
+    modelCyc = 0.0;
+    modelCoreHz = 180.0e6;
+    modelBusHz = 60.0e6;
+    modelBits8 = TRUE;
+    modelResetNibs = 0;
+    modelHaveHigh = FALSE;
+    modelInstrNs = 0.0;
+    modelBusyUntil = MODEL_T_POWER_NS;
+    modelRsNs = 0.0;
+    modelDbNs = 0.0;
+    modelAc = 0;
+    modelAcCg = FALSE;
+    modelIncr = TRUE;
+    modelTwoLine = FALSE;
+    modelDispOn = FALSE;
+    memset(modelDdram, ' ', sizeof(modelDdram));
+    memset(modelCgram, 0, sizeof(modelCgram));
+}
+
+/*****************************************************************************************
+* modelCheckPanel() - Compares the visible DDRAM with the expected lines.
+*****************************************************************************************/
+static void modelCheckPanel(const char *line1, const char *line2){
+    const char *lines[MODEL_ROWS];
+    INT8U row;
+    INT8U col;
+    INT8U ok = TRUE;
+    lines[0] = line1;
+    lines[1] = line2;
+    for(row = 0; row < MODEL_ROWS; row++){
+        for(col = 0; col < MODEL_COLS; col++){
+            if(modelDdram[(row*MODEL_LINE2_ADDR) + col] != (INT8U)lines[row][col]){
+                ok = FALSE;
+            }else{
+            }
+        }
+    }
+    if(ok == FALSE){
+        printf("  PANEL expected [%.16s][%.16s] got [", line1, line2);
+        for(row = 0; row < MODEL_ROWS; row++){
+            for(col = 0; col < MODEL_COLS; col++){
+                INT8U c = modelDdram[(row*MODEL_LINE2_ADDR) + col];
+                putchar(((c >= ' ') && (c <= '~')) ? c : '#');
+            }
+            printf((row == 0) ? "][" : "]\n");
+        }
+        modelPanelErrors++;
+    }else{
+    }
+}
+
+/*****************************************************************************************
+* modelCheckGlyph() - Compares the CGRAM slot of a displayed glyph code with its pattern.
+*****************************************************************************************/
+static void modelCheckGlyph(INT8C code, const INT8U *pattern){
+    INT8U slot = (INT8U)code & 0x07U;
+    if(((INT8U)code < 0x08U) || ((INT8U)code > 0x0FU) ||
+       (memcmp(&modelCgram[slot*8U], pattern, 8U) != 0)){
+        printf("  CGRAM glyph code 0x%02X does not hold its pattern\n", (INT8U)code);
+        modelPanelErrors++;
+    }else{
+    }
+}
+
+/*****************************************************************************************
+* modelMeasureStart(), modelMeasureEnd() - Around an API call. The call runs, then the
+*   model runs until the queue is empty. The bus time is the virtual time that took,
+*   shown with the LcdGetBusTime() difference LCD.c accounted for it.
+*****************************************************************************************/
+static FP64 modelMeasureNs;
+static INT32U modelMeasureInstrs;
+static INT32U modelMeasureBus;
+
+static void modelMeasureStart(void){
+    modelMeasureNs = modelNowNs;
+    modelMeasureInstrs = modelInstrs;
+    modelMeasureBus = LcdGetBusTime();
+}
+
+static void modelMeasureEnd(const char *name){
+    modelRunIdle();
+    printf("%-34s %4lu instr %10.1fus bus, LcdGetBusTime() %7luus\n", name,
+           (unsigned long)(modelInstrs - modelMeasureInstrs),
+           (modelNowNs - modelMeasureNs)/1000.0,
+           (unsigned long)(LcdGetBusTime() - modelMeasureBus));
+}
+
+/*****************************************************************************************
+* main() - Drives LCD.c the way Lab5Main.c does, at each clock it runs at.
+*****************************************************************************************/
+int main(void){
+    static const INT8U lock_glyph[8] = {0x0E,0x11,0x11,0x1F,0x1B,0x1B,0x1F,0x00};
+    static const INT8U bar1_glyph[8] = {0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x00};
+    char line2[MODEL_COLS + 1U];
+    INT32U saved;
+
+    modelPowerUp();
+    printf("HD44780 model of LCD.c, core %.0fMHz bus %.0fMHz\n", modelCoreHz/1.0e6,
+           modelBusHz/1.0e6);
+    modelMeasureStart();
+    LcdDispInit();
+    modelMeasureEnd("LcdDispInit()");
+    if((modelBits8 == TRUE) || (modelTwoLine == FALSE) || (modelDispOn == FALSE)){
+        printf("  init did not leave the panel in 4-bit 2-line mode, display on\n");
+        modelPanelErrors++;
+    }else{
+    }
+    modelCheckPanel("                ", "                ");
+
+    modelMeasureStart();
+    LcdDispString("DISARMED");
+    LcdTask();
+    modelMeasureEnd("LcdDispString(8 chars), LcdTask()");
+    modelCheckPanel("DISARMED        ", "                ");
+
+    modelMeasureStart();
+    LcdCursorMove(2,1);
+    LcdPrintf("CS: %04X", 0xBEEFU);
+    LcdTask();
+    modelMeasureEnd("LcdPrintf(8 chars), LcdTask()");
+    modelCheckPanel("DISARMED        ", "CS: BEEF        ");
+
+    modelMeasureStart();
+    LcdCursorMove(1,10);
+    LcdDispIcon(LCD_ICON_LOCK);
+    LcdTask();
+    modelMeasureEnd("LcdDispIcon(), LcdTask()");
+    modelCheckPanel("DISARMED \x08      ", "CS: BEEF        ");
+    modelCheckGlyph('\x08', lock_glyph);
+
+    modelMeasureStart();
+    LcdCursorMove(2,11);
+    LcdDispBar(6U, 37U, 100U);                  /* 11 of 30 columns */
+    LcdTask();
+    modelMeasureEnd("LcdDispBar(6 chars), LcdTask()");
+    memcpy(line2, "CS: BEEF  \xff\xff\x09   ", MODEL_COLS + 1U);
+    modelCheckPanel("DISARMED \x08      ", line2);
+    modelCheckGlyph('\x09', bar1_glyph);
+
+    modelMeasureStart();
+    LcdTask();
+    modelMeasureEnd("LcdTask(), nothing changed");
+
+    /* ClockTask() CLK_MODE_LOW, PBE 16MHz. The queue is idle, as ClockTask() waits */
+    modelSetClocks(16.0e6, 16.0e6);
+    LcdClkChange(16000000U, 16000000U);
+    printf("core %.0fMHz bus %.0fMHz\n", modelCoreHz/1.0e6, modelBusHz/1.0e6);
+    modelMeasureStart();
+    LcdDispLineClear(1);
+    LcdDispString("ARMED");
+    LcdTask();
+    modelMeasureEnd("LcdDispLineClear(), LcdDispString()");
+    modelCheckPanel("ARMED           ", line2);
+
+    /* CLK_PROFILE_FEI, the fractional clock */
+    modelSetClocks(MODEL_FEI_HZ, MODEL_FEI_HZ);
+    LcdClkChange((INT32U)MODEL_FEI_HZ, (INT32U)MODEL_FEI_HZ);
+    printf("core %.3fMHz bus %.3fMHz\n", modelCoreHz/1.0e6, modelBusHz/1.0e6);
+    modelMeasureStart();
+    LcdCursorMove(1,1);
+    LcdDispString("ALARM");
+    LcdTask();
+    modelMeasureEnd("LcdDispString(5 chars), LcdTask()");
+    modelCheckPanel("ALARM           ", line2);
+
+    /* CLK_PROFILE_BLPI, 4MHz */
+    modelSetClocks(4.0e6, 4.0e6);
+    LcdClkChange(4000000U, 4000000U);
+    printf("core %.0fMHz bus %.0fMHz\n", modelCoreHz/1.0e6, modelBusHz/1.0e6);
+    modelMeasureStart();
+    LcdDispClear();
+    LcdDispString("BLPI");
+    LcdTask();
+    modelMeasureEnd("LcdDispClear(), LcdDispString()");
+    modelCheckPanel("BLPI            ", "                ");
+
+    /* Back to CLK_PROFILE_PEE180 */
+    modelSetClocks(180.0e6, 60.0e6);
+    LcdClkChange(180000000U, 60000000U);
+    printf("core %.0fMHz bus %.0fMHz\n", modelCoreHz/1.0e6, modelBusHz/1.0e6);
+    modelMeasureStart();
+    LcdCursorMode(TRUE, FALSE);
+    LcdCursorMove(2,3);
+    LcdTask();
+    modelMeasureEnd("LcdCursorMode(), LcdTask()");
+    if((modelAcCg == TRUE) || (modelAc != (MODEL_LINE2_ADDR + 2U))){
+        printf("  cursor not at row 2 column 3\n");
+        modelPanelErrors++;
+    }else{
+    }
+    LcdCursorMode(FALSE, FALSE);
+    modelRunIdle();
+
+    /* Self check: a clock change from 16MHz to 60MHz bus while a settle time is counting
+     * ends it early. The model must report it, which is why ClockTask() waits.        */
+    saved = modelViolations;
+    modelSetClocks(16.0e6, 16.0e6);
+    LcdClkChange(16000000U, 16000000U);
+    LcdDispString("XY");
+    LcdTask();
+    modelRun(5000.0);
+    modelSetClocks(180.0e6, 60.0e6);
+    LcdClkChange(180000000U, 60000000U);
+    modelRunIdle();
+    printf("self check, clock change during a settle time: %lu violations (expected)\n",
+           (unsigned long)(modelViolations - saved));
+    if(modelViolations == saved){
+        printf("  the model missed the short settle time\n");
+        modelPanelErrors++;
+    }else{
+    }
+    modelViolations = saved;
+
+    printf("%lu E pulses, %lu instructions, %lu timing violations, %lu panel errors\n",
+           (unsigned long)modelEPulses, (unsigned long)modelInstrs,
+           (unsigned long)modelViolations, (unsigned long)modelPanelErrors);
+    return ((modelViolations == 0U) && (modelPanelErrors == 0U)) ? 0 : 1;
+}
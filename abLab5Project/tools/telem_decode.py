@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""telem_decode.py - Decodes the Telemetry.c snapshots sent on UART2.
+
+Packets are COBS(payload, crc) followed by a 0x00 delimiter, the CRC is
+CRC-16/CCITT-FALSE of the payload, little endian (see source/Telemetry.h).
+Shell text shares the UART, anything between delimiters that does not decode
+is counted as bad and skipped. A gap in seq is that many packets skipped.
+
+    telem_decode.py --port /dev/ttyACM0 [--baud 115200] [--csv out.csv]
+    telem_decode.py --file capture.bin [--csv out.csv]
+
+Reading a port needs pyserial (pip install pyserial). Ctrl-C ends the capture
+and prints the totals.
+10/18/2026
+"""
+import argparse
+import csv
+import struct
+import sys
+
+TELEM_TYPE_SNAP = 0x01
+TELEM_SNAP_SIZE = 20
+CRC_INIT = 0xFFFF
+CRC_POLY = 0x1021
+SNAP_FMT = "<BBIBHBHHHHHH"      # payload then crc, matches Telemetry.h
+FIELDS = ["seq", "uptime_ms", "alarm_state", "tsi_flags", "last_key",
+          "key_presses", "busy_us", "busy_max_us", "overruns", "checksum"]
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, bitwise."""
+    crc = CRC_INIT
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ CRC_POLY) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_decode(frame):
+    """Returns the decoded bytes, or None if frame is not valid COBS."""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def decode(frame):
+    """Returns the field dict of one packet, or None if it is bad."""
+    raw = cobs_decode(frame)
+    if raw is None or len(raw) != TELEM_SNAP_SIZE + 2:
+        return None
+    vals = struct.unpack(SNAP_FMT, raw)
+    if vals[0] != TELEM_TYPE_SNAP or crc16(raw[:TELEM_SNAP_SIZE]) != vals[-1]:
+        return None
+    snap = dict(zip(FIELDS, vals[1:-1]))
+    snap["last_key"] = chr(snap["last_key"]) if snap["last_key"] else ""
+    return snap
+
+
+def frames(chunks):
+    """Yields the bytes between 0x00 delimiters from an iterable of reads."""
+    buf = bytearray()
+    for chunk in chunks:
+        buf += chunk
+        while True:
+            end = buf.find(0)
+            if end < 0:
+                break
+            yield bytes(buf[:end])
+            del buf[:end + 1]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="serial port")
+    src.add_argument("--file", help="raw capture of the UART")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--csv", help="write the packets here, else stdout")
+    ap.add_argument("--quiet", action="store_true", help="totals only")
+    args = ap.parse_args()
+
+    if args.port:
+        import serial
+        stream = serial.Serial(args.port, args.baud, timeout=1)
+        chunks = iter(lambda: stream.read(256), None)   # until Ctrl-C
+    else:
+        stream = open(args.file, "rb")
+        chunks = iter(lambda: stream.read(256), b"")
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.DictWriter(out, fieldnames=FIELDS)
+    if not args.quiet or args.csv:
+        writer.writeheader()
+
+    good = bad = gaps = 0
+    next_seq = None
+    try:
+        for frame in frames(chunks):
+            if not frame:
+                continue
+            snap = decode(frame)
+            if snap is None:
+                bad += 1
+                continue
+            good += 1
+            if next_seq is not None:
+                gaps += (snap["seq"] - next_seq) & 0xFF
+            next_seq = (snap["seq"] + 1) & 0xFF
+            if not args.quiet or args.csv:
+                writer.writerow(snap)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stream.close()
+        if out is not sys.stdout:
+            out.close()
+    print("packets %d, bad %d, skipped by seq %d" % (good, bad, gaps),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""tsi_stream_decode.py - Decodes the TSIStream.c frames sent on UART2.
+
+A frame is 10 bytes, TSI_STREAM_SYNC (0xA5) then seq, channel, count,
+baseline and threshold, 16-bit values little endian, and a check byte that
+makes bytes 1-9 sum to zero mod 256 (see source/TSIStream.h). A 0xA5 inside
+a frame is not a sync, so on a bad check the search restarts one byte on.
+Bit 7 of the channel is set while the pad is touched.
+
+    tsi_stream_decode.py --port /dev/ttyACM0 [--baud 115200] [--csv out.csv]
+    tsi_stream_decode.py --file capture.bin [--csv out.csv] [--channel 9]
+    tsi_stream_decode.py --file capture.bin --plot [--channel 9]
+
+One row per frame, so each channel's count, baseline and threshold can be
+plotted against seq to set the touch offsets. --plot does that at the end
+of the capture, one panel per channel with the touched frames shaded; it
+needs matplotlib. Reading a port needs pyserial (pip install pyserial).
+Ctrl-C ends the capture and prints the totals.
+10/18/2026
+"""
+import argparse
+import csv
+import struct
+import sys
+
+TSI_STREAM_SYNC = 0xA5
+TSI_STREAM_FRAME_SIZE = 10
+TSI_TELEM_TOUCHED = 0x80
+FRAME_FMT = "<BBBHHHB"
+FIELDS = ["seq", "channel", "touched", "count", "baseline", "threshold"]
+
+
+def frames(chunks, totals):
+    """Yields the checked frames from an iterable of reads. Bytes skipped
+    looking for a sync go in totals["resync"]."""
+    buf = bytearray()
+    for chunk in chunks:
+        buf += chunk
+        while len(buf) >= TSI_STREAM_FRAME_SIZE:
+            if buf[0] == TSI_STREAM_SYNC and \
+               (sum(buf[1:TSI_STREAM_FRAME_SIZE]) & 0xFF) == 0:
+                yield bytes(buf[:TSI_STREAM_FRAME_SIZE])
+                del buf[:TSI_STREAM_FRAME_SIZE]
+            else:
+                totals["resync"] += 1
+                del buf[0]
+
+
+def plot(series):
+    """One panel per channel of count, baseline and threshold against the
+    frame number, seq unwrapped. series is {channel: [row, ...]}."""
+    import matplotlib.pyplot as plt
+    chans = sorted(series)
+    if not chans:
+        return
+    fig, axes = plt.subplots(len(chans), 1, sharex=True, squeeze=False,
+                             figsize=(10, 3 * len(chans)))
+    for ax, ch in zip(axes[:, 0], chans):
+        rows = series[ch]
+        x = [r["n"] for r in rows]
+        for key in ("count", "baseline", "threshold"):
+            ax.plot(x, [r[key] for r in rows], label=key)
+        ax.fill_between(x, 0, 1, where=[r["touched"] == 1 for r in rows],
+                        transform=ax.get_xaxis_transform(), alpha=0.2,
+                        step="mid", label="touched")
+        ax.set_ylabel("ch %d" % ch)
+        ax.legend(loc="upper right", fontsize="small")
+    axes[-1, 0].set_xlabel("frame (seq unwrapped)")
+    fig.tight_layout()
+    plt.show()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="serial port")
+    src.add_argument("--file", help="raw capture of the UART")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--csv", help="write the frames here, else stdout")
+    ap.add_argument("--channel", type=int, help="only this TSI channel")
+    ap.add_argument("--plot", action="store_true",
+                    help="plot the channels at the end (matplotlib)")
+    args = ap.parse_args()
+
+    if args.port:
+        import serial
+        stream = serial.Serial(args.port, args.baud, timeout=1)
+        chunks = iter(lambda: stream.read(256), None)   # until Ctrl-C
+    else:
+        stream = open(args.file, "rb")
+        chunks = iter(lambda: stream.read(256), b"")
+    out = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.DictWriter(out, fieldnames=FIELDS)
+    writer.writeheader()
+
+    totals = {"frames": 0, "dropped": 0, "resync": 0}
+    chans = {}
+    series = {}
+    next_seq = None
+    n = 0
+    try:
+        for frame in frames(chunks, totals):
+            _, seq, ch, count, base, thresh, _ = struct.unpack(FRAME_FMT, frame)
+            totals["frames"] += 1
+            if next_seq is not None:
+                totals["dropped"] += (seq - next_seq) & 0xFF
+                n += (seq - next_seq) & 0xFF
+            next_seq = (seq + 1) & 0xFF
+            row = {"seq": seq, "channel": ch & ~TSI_TELEM_TOUCHED & 0xFF,
+                   "touched": 1 if ch & TSI_TELEM_TOUCHED else 0,
+                   "count": count, "baseline": base, "threshold": thresh}
+            lo, hi = chans.get(row["channel"], (count, count))
+            chans[row["channel"]] = (min(lo, count), max(hi, count))
+            if args.channel is None or args.channel == row["channel"]:
+                writer.writerow(row)
+                if args.plot:
+                    series.setdefault(row["channel"], []).append(
+                        dict(row, n=n))
+            n += 1
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stream.close()
+        if out is not sys.stdout:
+            out.close()
+    print("frames %d, dropped by seq %d, bytes skipped %d" %
+          (totals["frames"], totals["dropped"], totals["resync"]),
+          file=sys.stderr)
+    for ch in sorted(chans):
+        print("ch %2d count %5d to %5d" % ((ch,) + chans[ch]), file=sys.stderr)
+    if args.plot:
+        plot(series)
+
+
+if __name__ == "__main__":
+    main()